@@ -0,0 +1,135 @@
+// bit_board.cpp
+#include "bit_board.hpp"
+#include "nurikabe_solver.hpp"
+#include <algorithm>
+
+// Заливка в бік старших бітів (Kogge-Stone): g — насіння, p — біти, по яких дозволено рухатися
+static bit_board::word fill_up(bit_board::word g, bit_board::word p) {
+    g |= p & (g << 1);  p &= p << 1;
+    g |= p & (g << 2);  p &= p << 2;
+    g |= p & (g << 4);  p &= p << 4;
+    g |= p & (g << 8);  p &= p << 8;
+    g |= p & (g << 16); p &= p << 16;
+    g |= p & (g << 32);
+    return g;
+}
+
+// Заливка в бік молодших бітів
+static bit_board::word fill_down(bit_board::word g, bit_board::word p) {
+    g |= p & (g >> 1);  p &= p >> 1;
+    g |= p & (g >> 2);  p &= p >> 2;
+    g |= p & (g >> 4);  p &= p >> 4;
+    g |= p & (g >> 8);  p &= p >> 8;
+    g |= p & (g >> 16); p &= p >> 16;
+    g |= p & (g >> 32);
+    return g;
+}
+
+// Метод для створення порожньої дошки
+void bit_board::reset(int rows, int cols) {
+    rows_ = rows;
+    cols_ = cols;
+    words_ = (cols + WORD_BITS - 1) / WORD_BITS;
+    black_.assign(rows_ * words_, 0);
+    filled_.assign(rows_ * words_, 0);
+    clue_.assign(rows_ * words_, 0);
+    open_.assign(rows_ * words_, 0);
+    reach_.assign(rows_ * words_, 0);
+    row_.assign(words_, 0);
+
+    // Останнє слово рядка може бути заповнене частково
+    valid_.assign(words_, ~word(0));
+    if (cols_ % WORD_BITS)
+        valid_[words_ - 1] = (word(1) << (cols_ % WORD_BITS)) - 1;
+}
+
+// Метод для запису стану клітинки у відповідну площину
+void bit_board::set(int r, int c, int value) {
+    int w = r * words_ + c / WORD_BITS;
+    word bit = word(1) << (c % WORD_BITS);
+
+    black_[w] &= ~bit;
+    filled_[w] &= ~bit;
+    clue_[w] &= ~bit;
+
+    if (value == nurikabe_solver::BLACK)       black_[w] |= bit;
+    else if (value == nurikabe_solver::FILLED ||
+             value == nurikabe_solver::WHITE)  filled_[w] |= bit;
+    else if (value > 0)                        clue_[w] |= bit;
+}
+
+// Метод для побудови маски клітинок, які можуть бути чорними
+void bit_board::open_row(int r, word *out) const {
+    for (int w = 0; w < words_; ++w) {
+        int id = r * words_ + w;
+        out[w] = valid_[w] & ~(filled_[id] | clue_[id]);
+    }
+}
+
+// Метод для заливки рядка в межах відкритих бітів з переносом між словами
+void bit_board::saturate_row(word *g, const word *open) const {
+    // Від молодших слів до старших
+    word carry = 0;
+    for (int w = 0; w < words_; ++w) {
+        g[w] = fill_up(g[w] | (carry & open[w]), open[w]);
+        carry = g[w] >> (WORD_BITS - 1);
+    }
+    // Від старших слів до молодших
+    carry = 0;
+    for (int w = words_ - 1; w >= 0; --w) {
+        g[w] = fill_down(g[w] | ((carry << (WORD_BITS - 1)) & open[w]), open[w]);
+        carry = g[w] & 1;
+    }
+}
+
+// Метод для перевірки зв'язності чорних і порожніх клітинок
+bool bit_board::is_open_area_connected() const {
+    std::vector<word> &open = open_, &reach = reach_, &row = row_;
+    for (int r = 0; r < rows_; ++r) open_row(r, &open[r * words_]);
+    std::fill(reach.begin(), reach.end(), 0);
+
+    // Насіння заливки — перший відкритий біт
+    int seed = -1;
+    for (int i = 0; i < rows_ * words_ && seed < 0; ++i) {
+        if (open[i]) {
+            seed = i;
+            reach[i] = open[i] & (~open[i] + 1);
+        }
+    }
+    // Якщо не було знайдено ні одної клітинки — нульова область вважається зв'язною
+    if (seed < 0) return true;
+
+    /*
+        Поширюємо фронт почергово зверху вниз і знизу вгору, поки він змінюється.
+        Кожен рядок отримує біти від сусіднього рядка і насичується по горизонталі
+    */
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int k = 0; k < rows_; ++k) {
+                int r = pass == 0 ? k : rows_ - 1 - k;
+                int nr = pass == 0 ? r - 1 : r + 1;
+                word *cur = &reach[r * words_];
+                const word *op = &open[r * words_];
+                bool any = false;
+                for (int w = 0; w < words_; ++w) {
+                    row[w] = cur[w];
+                    if (nr >= 0 && nr < rows_) row[w] |= reach[nr * words_ + w] & op[w];
+                    any |= row[w] != 0;
+                }
+                if (!any) continue;
+                saturate_row(row.data(), op);
+                for (int w = 0; w < words_; ++w) {
+                    if (row[w] != cur[w]) {
+                        cur[w] = row[w];
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Область зв'язна, якщо заливка з насіння покрила всі відкриті клітинки
+    return reach == open;
+}
@@ -0,0 +1,49 @@
+// bit_board.hpp
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+/*
+    Бітове представлення робочої сітки розв'язувача.
+    Кожна площина (чорні, заповнені, підказки) зберігається як упаковані рядки:
+    рядок займає words_ машинних слів, біт c % 64 слова c / 64 відповідає стовпцю c.
+    Порожні клітинки окремо не зберігаються — це всі валідні біти, що не входять у жодну площину.
+*/
+class bit_board {
+public:
+    using word = std::uint64_t;
+    static constexpr int WORD_BITS = 64;
+
+    bit_board() = default;
+
+    // Створює порожню дошку заданого розміру
+    void reset(int rows, int cols);
+
+    // Записує стан клітинки, значення кодуються як у nurikabe_solver::cell_state (або підказка > 0)
+    void set(int r, int c, int value);
+
+    // Перевіряє, чи всі чорні та порожні клітинки утворюють одну зв'язну область (заливка зсувами і масками)
+    bool is_open_area_connected() const;
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    int words_ = 0;              // кількість слів на один рядок
+
+    std::vector<word> black_;    // площина чорних клітинок (rows_ * words_)
+    std::vector<word> filled_;   // площина заповнених (і відомих білих) клітинок острова
+    std::vector<word> clue_;     // площина клітинок з підказками
+    std::vector<word> valid_;    // маска існуючих стовпців одного рядка (words_)
+
+    // Робочі буфери перевірки зв'язності, виділені в reset, щоб перевірка у вузлі пошуку не виділяла пам'ять
+    mutable std::vector<word> open_;   // відкриті клітинки (rows_ * words_)
+    mutable std::vector<word> reach_;  // заливка від насіння (rows_ * words_)
+    mutable std::vector<word> row_;    // рядок, що насичується (words_)
+
+    // Маска клітинок, які можуть бути чорними (чорні або порожні) для рядка r
+    void open_row(int r, word *out) const;
+
+    // Насичує рядок заливки g вздовж відкритих бітів open в обидва боки (з переносом між словами)
+    void saturate_row(word *g, const word *open) const;
+};
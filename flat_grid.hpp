@@ -0,0 +1,73 @@
+// flat_grid.hpp
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/*
+    Плоска сітка, що зберігається одним суцільним масивом з рамкою в одну клітинку навколо поля.
+    Клітинка (r, c) має індекс (r + 1) * stride() + (c + 1), тож сусіди клітинки id — це id ± 1 та id ± stride(),
+    і перевірка виходу за межі не потрібна: рамка заповнена значенням BORDER
+*/
+class flat_grid {
+public:
+    // Значення клітинок рамки (не порожня, не чорна, не острів і не підказка)
+    static constexpr int BORDER = -3;
+
+    flat_grid() = default;
+
+    // Створює сітку rows × cols, заповнену значенням fill, з рамкою BORDER
+    flat_grid(int rows, int cols, int fill = 0)
+        : rows_(rows), cols_(cols), cells_((rows + 2) * (cols + 2), BORDER)
+    {
+        for (int r = 0; r < rows_; ++r)
+            for (int c = 0; c < cols_; ++c)
+                cells_[index(r, c)] = fill;
+    }
+
+    // Перебудовує сітку під розміри rows × cols, повторно використовуючи вже виділену пам'ять
+    void reset(int rows, int cols, int fill = 0) {
+        rows_ = rows;
+        cols_ = cols;
+        cells_.assign(static_cast<std::size_t>(rows + 2) * (cols + 2), BORDER);
+        for (int r = 0; r < rows_; ++r)
+            for (int c = 0; c < cols_; ++c)
+                cells_[index(r, c)] = fill;
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+    // Відстань між сусідніми рядками в масиві
+    int stride() const { return cols_ + 2; }
+
+    // Розмір масиву разом з рамкою
+    int size() const { return static_cast<int>(cells_.size()); }
+
+    // Індекс клітинки (r, c) в масиві
+    int index(int r, int c) const { return (r + 1) * stride() + c + 1; }
+
+    // Координати клітинки за індексом
+    int row_of(int id) const { return id / stride() - 1; }
+    int col_of(int id) const { return id % stride() - 1; }
+
+    // Доступ за координатами
+    int &at(int r, int c) { return cells_[index(r, c)]; }
+    int at(int r, int c) const { return cells_[index(r, c)]; }
+
+    // Доступ за індексом масиву
+    int &operator[](int id) { return cells_[id]; }
+    int operator[](int id) const { return cells_[id]; }
+
+    bool empty() const { return cells_.empty(); }
+
+    bool operator==(const flat_grid &other) const {
+        return rows_ == other.rows_ && cols_ == other.cols_ && cells_ == other.cells_;
+    }
+    bool operator!=(const flat_grid &other) const { return !(*this == other); }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    std::vector<int> cells_;
+};
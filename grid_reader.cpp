@@ -2,6 +2,8 @@
 #include "grid_reader.hpp"
 #include <limits>
 #include <fstream>
+#include <charconv>
+#include <cstring>
 
 // Зчитування сітки з консолі
 grid_data grid_reader::from_console(std::istream &in, std::ostream &out) {
@@ -25,7 +27,7 @@ grid_data grid_reader::from_console(std::istream &in, std::ostream &out) {
         in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
 
-    data.grid.assign(data.rows, std::vector<int>(data.cols, 0));
+    data.grid = flat_grid(data.rows, data.cols);
     out << "\nПримітка:\n"
         "n = 0  — пуста клітинка\n"
         "n > 0  — підказка (ціле число)\n\n";
@@ -41,13 +43,13 @@ grid_data grid_reader::from_console(std::istream &in, std::ostream &out) {
             int temp_hint_sum = 0;
             bool format_error = false;
             for (int c = 0; c < data.cols; ++c) {
-                if (!(in >> data.grid[r][c])) {
+                if (!(in >> data.grid.at(r, c))) {
                     out << "Помилка: введіть ціле число.\n";
                     format_error = true;
                     break;
                 }
 
-                int v = data.grid[r][c];
+                int v = data.grid.at(r, c);
                 // Дозволяємо тільки додатні значення
                 if (v < 0) {
                     out << "Помилка: від’ємне значення.\n";
@@ -60,14 +62,14 @@ grid_data grid_reader::from_console(std::istream &in, std::ostream &out) {
                     format_error = true;
                     break;
                 }
-                // Перевірка сусідніх підказок і суми
+                // Перевірка сусідніх підказок і суми (рамка сітки ніколи не є підказкою)
                 if (v > 0) {
-                    if (c > 0 && data.grid[r][c - 1] > 0) {
+                    if (data.grid.at(r, c - 1) > 0) {
                         out << "Помилка: сусідні підказки.\n";
                         format_error = true;
                         break;
                     }
-                    if (r > 0 && data.grid[r - 1][c] > 0) {
+                    if (data.grid.at(r - 1, c) > 0) {
                         out << "Помилка: сусідні підказки.\n";
                         format_error = true;
                         break;
@@ -99,26 +101,213 @@ grid_data grid_reader::from_console(std::istream &in, std::ostream &out) {
 
 // Зчитування сітки з файлу
 grid_data grid_reader::from_file(const std::string &filepath) {
-    std::ifstream fin(filepath);
+    std::ifstream fin(filepath, std::ios::binary);
     if (!fin) {
         throw std::runtime_error("Не вдалося відкрити файл " + filepath);
     }
 
-    // Перші 2 числа - розмірі сітки
-    grid_data data;
-    if (!(fin >> data.rows >> data.cols) || data.rows <= 0 || data.cols <= 0) {
+    // Перша сітка файлу; помилка формату повідомляється разом з місцем у файлі
+    grid_stream stream(fin);
+    parsed_grid parsed;
+    if (!stream.next(parsed)) {
         throw std::runtime_error("Невірний формат розмірів у файлі");
     }
+    if (!parsed.ok()) {
+        throw std::runtime_error(parsed.error + " (" + filepath + ", рядок " + std::to_string(parsed.line) +
+                                 ", стовпець " + std::to_string(parsed.column) + ")");
+    }
+    return std::move(parsed.data);
+}
 
-    // Зчитуєм в матрицю
-    data.grid.assign(data.rows, std::vector<int>(data.cols));
-    for (int r = 0; r < data.rows; ++r) {
-        for (int c = 0; c < data.cols; ++c) {
-            if (!(fin >> data.grid[r][c])) {
-                throw std::runtime_error("Недостатньо даних у файлі");
-            }
+// Розбір цілого числа з тексту без виділення пам'яті і без залежності від локалі
+bool number_reader::parse(const token &t, int &value) {
+    // Як і operator>>, допускаємо явний знак "+"
+    const char *begin = t.begin;
+    if (begin != t.end && *begin == '+' && t.end - begin > 1 && begin[1] != '-') ++begin;
+    auto result = std::from_chars(begin, t.end, value);
+    return result.ec == std::errc() && result.ptr == t.end;
+}
+
+static bool is_space(char ch) {
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\v' || ch == '\f';
+}
+
+number_reader::number_reader(std::istream &in, std::size_t chunk_size) : in_(in), buffer_(chunk_size > 0 ? chunk_size : 1) {}
+
+// Метод для дочитування потоку в буфер
+bool number_reader::refill(std::size_t keep) {
+    // Незавершене число переносимо на початок буфера; якщо воно займає весь буфер — розширюємо його
+    std::size_t rest = filled_ - keep;
+    if (rest > 0 && keep > 0) std::memmove(buffer_.data(), buffer_.data() + keep, rest);
+    base_ += static_cast<long long>(keep);
+    pos_ -= keep;
+    filled_ = rest;
+    if (eof_) return false;
+    if (filled_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+
+    in_.read(buffer_.data() + filled_, static_cast<std::streamsize>(buffer_.size() - filled_));
+    std::size_t got = static_cast<std::size_t>(in_.gcount());
+    filled_ += got;
+    if (got == 0) eof_ = true;
+    return got > 0;
+}
+
+// Метод для читання наступного числа
+bool number_reader::next(token &t) {
+    // Пропуск пробілів з підрахунком рядків; два переходи рядка поспіль — порожній рядок
+    int newlines = 0;
+    while (true) {
+        if (pos_ == filled_ && !refill(filled_)) return false;
+        char ch = buffer_[pos_];
+        if (!is_space(ch)) break;
+        ++pos_;
+        if (ch == '\n') {
+            ++newlines;
+            ++line_;
+            line_start_ = base_ + static_cast<long long>(pos_);
         }
     }
 
-    return data;
+    // Саме число — до наступного пробілу або кінця потоку
+    std::size_t start = pos_;
+    while (true) {
+        if (pos_ == filled_) {
+            bool more = refill(start);
+            start = 0;
+            if (!more) break;
+        }
+        if (is_space(buffer_[pos_])) break;
+        ++pos_;
+    }
+
+    t.begin = buffer_.data() + start;
+    t.end = buffer_.data() + pos_;
+    t.line = line_;
+    t.column = base_ + static_cast<long long>(start) - line_start_ + 1;
+    t.after_blank = newlines >= 2;
+    end_line_ = t.line;
+    end_column_ = t.column + static_cast<long long>(pos_ - start);
+    return true;
+}
+
+grid_stream::grid_stream(std::istream &in, std::size_t chunk_size) : reader_(in, chunk_size) {}
+
+// Метод для читання наступного числа, починаючи з відкладеного
+bool grid_stream::read_token(token &t) {
+    if (pending_) {
+        pending_ = false;
+        t = pending_token_;
+        return true;
+    }
+    return reader_.next(t);
+}
+
+// Метод для читання наступного числа в межах поточної сітки
+bool grid_stream::next_in_grid(token &t, parsed_grid &result, bool new_line, int lines_left, const char *message) {
+    // Сітка може обірватись: тоді помилка вказує на місце одразу після її останнього числа
+    long long line = reader_.end_line(), column = reader_.end_column();
+    bool read = read_token(t);
+    if (!read || (t.after_blank && lines_left == 0)) {
+        if (read) {
+            pending_ = true;
+            pending_token_ = t;
+        }
+        result.error = message;
+        result.line = line;
+        result.column = column;
+        return false;
+    }
+
+    /*
+        Порожній рядок, після якого сітка ще має рядки, — розрив усередині сітки, а не її кінець.
+        Решту рядків сітки пропускаємо (перший з них починається з t), щоб вона не стала окремою зіпсованою сіткою
+    */
+    if (t.after_blank) {
+        result.error = "Порожній рядок усередині сітки";
+        result.line = line + 1;
+        result.column = 1;
+        skip(t.line, lines_left - 1);
+        return false;
+    }
+
+    // Рядок сітки містить рівно cols чисел: зайве число вказується саме, нестача — місцем кінця рядка
+    if (new_line && t.line == line) {
+        fail(result, t.line, t.column, "Зайве число в рядку");
+        return false;
+    }
+    if (!new_line && t.line != line) {
+        fail(result, line, column, "Недостатньо чисел у рядку");
+        return false;
+    }
+    return true;
+}
+
+// Метод для запису помилки і пропуску залишку сітки
+bool grid_stream::fail(parsed_grid &result, long long line, long long column, const char *message) {
+    result.error = message;
+    result.line = line;
+    result.column = column;
+    skip(line, 0);
+    return true;
+}
+
+// Метод для пропуску залишку сітки: ще lines рядків тексту після рядка line, далі все до порожнього рядка
+void grid_stream::skip(long long line, int lines) {
+    token t;
+    while (read_token(t)) {
+        // Перше число нового рядка; порожні рядки перед ним не рахуються, поки сітка ще має рядки
+        if (t.line != line && lines > 0) {
+            --lines;
+            line = t.line;
+            continue;
+        }
+        if (t.after_blank) {
+            pending_ = true;
+            pending_token_ = t;
+            break;
+        }
+    }
+}
+
+// Метод для розбору наступної сітки
+bool grid_stream::next(parsed_grid &result) {
+    token t;
+    if (!read_token(t)) return false;
+
+    result.number = ++number_;
+    result.error.clear();
+    result.line = result.column = 0;
+
+    // Розміри
+    int rows = 0, cols = 0;
+    if (!number_reader::parse(t, rows) || rows <= 0) return fail(result, t, "Невірний формат розмірів");
+    if (!next_in_grid(t, result, false, 0, "Невірний формат розмірів")) return true;
+    if (!number_reader::parse(t, cols) || cols <= 0) return fail(result, t, "Невірний формат розмірів");
+    // Зіпсований заголовок не повинен призводити до виділення гігантської сітки
+    if (rows > grid_reader::MAX_SIDE || cols > grid_reader::MAX_SIDE) return fail(result, t, "Завеликі розміри сітки");
+
+    // Клітинки записуються прямо в сітку результату, пам'ять якої перевикористовується
+    result.data.rows = rows;
+    result.data.cols = cols;
+    result.data.grid.reset(rows, cols);
+    int max_value = rows * cols;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            // Рядків сітки, що ще не почалися: з поточним, якщо число стоїть на початку рядка
+            int lines_left = rows - r - (c == 0 ? 0 : 1);
+            if (!next_in_grid(t, result, c == 0, lines_left, "Недостатньо даних для сітки")) return true;
+            int &v = result.data.grid.at(r, c);
+            if (!number_reader::parse(t, v)) return fail(result, t, "Невірне число");
+            if (v < 0 || v > max_value) return fail(result, t, "Недопустиме значення клітинки");
+        }
+    }
+
+    // Після останнього рядка сітка закінчується порожнім рядком або кінцем потоку
+    long long line = reader_.end_line();
+    if (read_token(t)) {
+        if (!t.after_blank) return fail(result, t, t.line == line ? "Зайве число в рядку" : "Зайвий рядок у сітці");
+        pending_ = true;
+        pending_token_ = t;
+    }
+    return true;
 }
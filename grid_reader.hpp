@@ -4,17 +4,22 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
+#include "flat_grid.hpp"
 
 // Структура для зберігання розмірів і значень сітки
 struct grid_data {
     int rows;
     int cols;
-    std::vector<std::vector<int>> grid;
+    flat_grid grid;
 };
 
 class grid_reader {
 public:
+    // Найбільша допустима кількість рядків або стовпців при зчитуванні з потоку
+    static constexpr int MAX_SIDE = 4096;
+
     /*
         Зчитування сітки з консолі (std::cin / std::cout)
         У разі помилки форматування кидає виняток std::runtime_error
@@ -27,3 +32,137 @@ public:
     */
     static grid_data from_file(const std::string &filepath);
 };
+
+/*
+    Читання чисел з потоку великими блоками. Число повертається як межі в буфері разом з рядком і стовпцем,
+    де воно починається; межі дійсні до наступного виклику next. Розбір — parse (std::from_chars),
+    тож читання не залежить від локалі й не виділяє пам'ять на кожне число чи рядок
+*/
+class number_reader {
+public:
+    // Розмір блоку читання за замовчуванням
+    static constexpr std::size_t DEFAULT_CHUNK = 1 << 16;
+
+    // Число в тексті: межі в буфері і місце початку
+    struct token {
+        const char *begin = nullptr;
+        const char *end = nullptr;
+        long long line = 0;
+        long long column = 0;
+        bool after_blank = false;   // перед числом був порожній рядок
+    };
+
+    explicit number_reader(std::istream &in, std::size_t chunk_size = DEFAULT_CHUNK);
+
+    // Читає наступне число; false — потік закінчився
+    bool next(token &t);
+
+    // Розбирає ціле число; false — текст числа некоректний
+    static bool parse(const token &t, int &value);
+
+    // Місце одразу після останнього прочитаного числа
+    long long end_line() const { return end_line_; }
+    long long end_column() const { return end_column_; }
+
+private:
+    std::istream &in_;
+    std::vector<char> buffer_;
+    std::size_t pos_ = 0;           // поточна позиція в буфері
+    std::size_t filled_ = 0;        // кількість прочитаних у буфер байтів
+    bool eof_ = false;
+    long long base_ = 0;            // зміщення buffer_[0] від початку потоку
+    long long line_ = 1;            // номер поточного рядка
+    long long line_start_ = 0;      // зміщення початку поточного рядка від початку потоку
+    long long end_line_ = 1;
+    long long end_column_ = 1;
+
+    // Зсуває непрочитані байти, починаючи з keep, на початок буфера і дочитує потік; false — нових даних немає
+    bool refill(std::size_t keep);
+};
+
+// Результат розбору однієї сітки потоковим читачем
+struct parsed_grid {
+    long long number = 0;   // порядковий номер сітки в потоці (від 1)
+    grid_data data;         // сітка (дійсна, лише якщо ok())
+    std::string error;      // опис помилки формату або порожній рядок
+    long long line = 0;     // рядок і стовпець (від 1), де знайдено помилку
+    long long column = 0;
+
+    bool ok() const { return error.empty(); }
+};
+
+/*
+    Потоковий читач сіток у форматі input.txt поверх number_reader: не залежить від локалі й не виділяє пам'ять
+    на кожен рядок, а сітка результату перевикористовує свою пам'ять.
+    Сітки розділяються порожнім рядком; розміри займають один рядок, кожен рядок сітки — окремий рядок тексту
+    рівно з cols чисел. Зіпсована сітка повертається з описом помилки, рядком і стовпцем, після чого читач
+    пропускає її залишок до порожнього рядка і продовжує з наступної сітки, тож кожна сітка дає рівно один результат.
+    Порожній рядок до останнього рядка сітки її не завершує: це помилка, а решта рядків сітки пропускається разом з нею.
+
+    Використання:
+        grid_stream stream(in);
+        for (const parsed_grid &g : stream) { ... }
+*/
+class grid_stream {
+public:
+    static constexpr std::size_t DEFAULT_CHUNK = number_reader::DEFAULT_CHUNK;
+
+    explicit grid_stream(std::istream &in, std::size_t chunk_size = DEFAULT_CHUNK);
+
+    // Розбирає наступну сітку в result; false — потік закінчився
+    bool next(parsed_grid &result);
+
+    // Ітератор по сітках потоку; усі ітератори посилаються на один результат, який перезаписується
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = parsed_grid;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const parsed_grid *;
+        using reference = const parsed_grid &;
+
+        iterator() = default;
+        explicit iterator(grid_stream *stream) : stream_(stream) { ++*this; }
+
+        reference operator*() const { return stream_->current_; }
+        pointer operator->() const { return &stream_->current_; }
+        iterator &operator++() {
+            if (!stream_->next(stream_->current_)) stream_ = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator &other) const { return stream_ == other.stream_; }
+        bool operator!=(const iterator &other) const { return stream_ != other.stream_; }
+
+    private:
+        grid_stream *stream_ = nullptr;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    using token = number_reader::token;
+
+    number_reader reader_;
+    long long number_ = 0;          // кількість повернутих сіток
+    bool pending_ = false;          // pending_token_ уже прочитано, але він належить наступній сітці
+    token pending_token_;
+    parsed_grid current_;           // результат для ітератора
+
+    // Читає наступне число з урахуванням відкладеного; false — потік закінчився
+    bool read_token(token &t);
+
+    /*
+        Читає наступне число поточної сітки: з нового рядка тексту (new_line) або з того самого;
+        lines_left — скільки рядків сітки ще не почалося. false — сітка обірвалась (помилку message записано
+        в result) або порушено рядки (помилку записано, залишок сітки пропущено)
+    */
+    bool next_in_grid(token &t, parsed_grid &result, bool new_line, int lines_left, const char *message);
+
+    // Записує помилку в result і пропускає залишок сітки до порожнього рядка
+    bool fail(parsed_grid &result, long long line, long long column, const char *message);
+    bool fail(parsed_grid &result, const token &at, const char *message) { return fail(result, at.line, at.column, message); }
+
+    // Пропускає ще lines рядків сітки після рядка line (порожні рядки між ними не рахуються), далі — до порожнього рядка
+    void skip(long long line, int lines);
+};
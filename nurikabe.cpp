@@ -4,16 +4,18 @@
 #include <fstream>
 #include <stdexcept>
 #include <chrono>
+#include <string>
+#include <cstdlib>
 #include "grid_reader.hpp"
 #include "nurikabe_solver.hpp"
 #include "user_solution_checker.hpp"
 
-using grid = std::vector<std::vector<int>>;
+using grid = flat_grid;
 
 // Вивід довільної сітки у консолі
 void display(const grid &grid) {
-    int rows = grid.size();
-    int cols = rows ? grid[0].size() : 0;
+    int rows = grid.rows();
+    int cols = grid.cols();
 
     const std::string horizontal = "───";
     const std::string corner_tl = "┌", corner_tr = "┐";
@@ -30,7 +32,7 @@ void display(const grid &grid) {
     for (int r = 0; r < rows; ++r) {
         std::cout << vertical;
         for (int c = 0; c < cols; ++c) {
-            int v = grid[r][c];
+            int v = grid.at(r, c);
             if (v == nurikabe_solver::FILLED)
                 std::cout << " #";
             else if (v == nurikabe_solver::BLACK)
@@ -50,9 +52,23 @@ void display(const grid &grid) {
     std::cout << corner_br << "\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
     nurikabe_solver solver;
 
+    /*
+        --stats: після кожного розв'язання виводиться статистика пошуку;
+        --time-limit секунди: розв'язання, що триває довше, переривається
+    */
+    solver_stats stats;
+    bool show_stats = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stats") show_stats = true;
+        else if (arg == "--time-limit" && i + 1 < argc) solver.set_time_limit(std::atof(argv[++i]));
+        else std::cerr << "Невідомий параметр: " << arg << "\n";
+    }
+    if (show_stats) solver.set_stats(&stats);
+
     while (true) {
         std::cout << "\n=== Головне меню ===\n"
                 << "1) Ввести вхідні дані вручну\n"
@@ -81,57 +97,70 @@ int main() {
                 std::cout << "\n--- Режим розв'язання ---\n"
                         << "1) Ввести своє рішення для перевірки\n"
                         << "2) Покроково вирішити програмно\n"
-                        << "3) Повернутися до головного меню\n"
+                        << "3) Покроково вирішити паралельно (усі ядра)\n"
+                        << "4) Повернутися до головного меню\n"
                         << "\nВаш вибір: ";
                 int choice2;
-                if (!(std::cin >> choice2) || choice2 == 3) break;
+                if (!(std::cin >> choice2) || choice2 == 4) break;
 
                 if (choice2 == 1) {
                     user_solution_checker checker(data.grid);
                     checker.input_solution_interactive(std::cin, std::cout);
-                } else if (choice2 == 2) {
+                } else if (choice2 == 2 || choice2 == 3) {
                     try {
+                        /*
+                            Кроки виводяться в міру надходження: тримаємо лише одну сітку і накладаємо на неї зміни.
+                            Час розв'язання — до першого кроку, тобто без виводу
+                        */
+                        grid current = data.grid;
                         auto start = std::chrono::high_resolution_clock::now();
-                        auto steps = solver.solve(data.grid);
-                        auto end = std::chrono::high_resolution_clock::now();
+                        auto end = start;
+                        auto show_step = [&](const nurikabe_solver::solve_step &step) {
+                            if (step.number == 1) {
+                                end = std::chrono::high_resolution_clock::now();
+                                std::cout << "\n--- Покрокове рішення ---\n";
+                            }
+                            nurikabe_solver::apply_step(current, step);
+                            std::cout << "Крок " << step.number << " з " << step.total << ":\n";
+                            display(current);
+                            std::cout << "---\n";
+                        };
+                        if (choice2 == 2) solver.solve(data.grid, show_step);
+                        else solver.solve_parallel(data.grid, show_step);
                         std::chrono::duration<double> duration = end - start;
 
-                        std::cout << "\n--- Покрокове рішення ---\n";
-                        for (size_t i = 0; i < steps.size(); ++i) {
-                            std::cout << "Крок " << (i+1) << " з " << steps.size() << ":\n";
-                            display(steps[i]);
-                            std::cout << "---\n";
-                        }
                         std::cout << "Час розв'язання: " << std::fixed << std::setprecision(2) << duration.count() << " секунд\n";
                     } catch (const std::runtime_error &e) {
                         std::cerr << e.what() << "\n";
                     }
+                    if (show_stats) stats.print(std::cout);
                 } else {
                     std::cerr << "Невірний пункт меню\n";
                 }
             }
 
         } else if (choice1 == 2) {
-            std::ifstream fin("input.txt");
+            std::ifstream fin("input.txt", std::ios::binary);
             if (!fin) {
                 std::cerr << "Не вдалося відкрити input.txt\n";
                 continue;
             }
 
+            /*
+                Зіпсована сітка не зупиняє тести: повідомляємо, де саме помилка, і переходимо до наступної.
+                Номер тесту — порядковий номер сітки у файлі
+            */
+            grid_stream stream(fin);
             int test_number = 0;
-            while (true) {
-                grid_data data;
-                if (!(fin >> data.rows >> data.cols)) break;
-
-                data.grid.assign(data.rows, std::vector<int>(data.cols));
-                for (int r = 0; r < data.rows; ++r) {
-                    for (int c = 0; c < data.cols; ++c) {
-                        if (!(fin >> data.grid[r][c])) {
-                            std::cerr << "Недостатньо даних у input.txt для тесту " << (test_number + 1) << "\n";
-                            goto end_tests;
-                        }
-                    }
+            int bad_count = 0;
+            for (const parsed_grid &parsed : stream) {
+                if (!parsed.ok()) {
+                    std::cerr << "input.txt, сітка " << parsed.number << " (рядок " << parsed.line << ", стовпець "
+                              << parsed.column << "): " << parsed.error << "\n";
+                    bad_count++;
+                    continue;
                 }
+                const grid_data &data = parsed.data;
 
                 test_number++;
                 std::cout << "\n=== Тест " << test_number << " ===\n";
@@ -139,22 +168,27 @@ int main() {
                 display(data.grid);
 
                 try {
+                    // Проміжні сітки не потрібні — накладаємо всі кроки на одну
+                    grid solved = data.grid;
                     auto start = std::chrono::high_resolution_clock::now();
-                    auto steps = solver.solve(data.grid);
+                    solver.solve(data.grid, [&](const nurikabe_solver::solve_step &step) {
+                        nurikabe_solver::apply_step(solved, step);
+                    });
                     auto end = std::chrono::high_resolution_clock::now();
                     std::chrono::duration<double> duration = end - start;
 
                     std::cout << "\nРозв'язана сітка:\n";
-                    display(steps.back());
+                    display(solved);
 
                     std::cout << "Час розв'язання: " << std::fixed << std::setprecision(2) << duration.count() << " секунд\n";
                 } catch (const std::runtime_error &e) {
                     std::cerr << "Помилка при розв'язанні тесту " << test_number << ": " << e.what() << "\n";
                 }
+                if (show_stats) stats.print(std::cout);
             }
 
-            end_tests:
             std::cout << "\n=== Виконано " << test_number << " тестів ===\n";
+            if (bad_count) std::cerr << "Пропущено зіпсованих сіток: " << bad_count << "\n";
 
         } else {
             std::cerr << "Невірний пункт меню\n";
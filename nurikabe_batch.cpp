@@ -0,0 +1,338 @@
+// nurikabe_batch.cpp
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+#include "grid_reader.hpp"
+#include "nurikabe_solver.hpp"
+#include "puzzle_corpus.hpp"
+
+/*
+    Пакетний розв'язувач без меню: читає сітки з файлів (або stdin) у форматі input.txt,
+    розв'язує їх паралельно на пулі потоків і виводить по одному рядку на сітку в порядку введення.
+    Рядки виводяться, щойно готові всі попередні, а кількість сіток у роботі обмежена вікном,
+    тож пам'ять не залежить від розміру вхідних даних.
+
+    Використання: nurikabe_batch [-j потоки] [--format jsonl|csv] [--time-limit секунди] [--node-limit вузли]
+                                 [--engine native|sat] [файл ...]
+    --engine вибирає рушій розв'язання: власний пошук (native, за замовчуванням) або SAT-кодування (sat).
+    Без файлів або з файлом "-" читається stdin. Бінарні корпуси (nurikabe_corpus pack) розпізнаються за сигнатурою.
+
+    Рядок результату: id, status (solved / unsolvable / interrupted / error), time_ms, solution.
+    interrupted — сітку не розв'язано в межах обмежень, тож невідомо, чи має вона рішення.
+    solution — рядки сітки через '/', у рядку '1' — чорна клітинка, '0' — біла (острів або число)
+*/
+
+using grid = flat_grid;
+
+// Завдання для пулу: сітка або помилка зчитування
+struct batch_job {
+    long long id = 0;
+    bool bad = false;
+    std::string error;
+    grid puzzle;
+};
+
+// Спільний стан пулу потоків
+struct batch_state {
+    std::mutex lock;
+    std::condition_variable job_ready;     // з'явилось завдання або введення закінчилось
+    std::condition_variable window_free;   // виведено рядок, вікно звільнилось
+    std::deque<batch_job> jobs;
+    bool input_done = false;
+
+    std::map<long long, std::string> ready; // готові рядки, що чекають на попередні
+    long long next_output = 1;              // id наступного рядка для виводу
+};
+
+enum class output_format { JSONL, CSV };
+
+// Екранування рядка для JSON
+static std::string json_escape(const std::string &s) {
+    std::string out;
+    for (unsigned char ch : s) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += static_cast<char>(ch);
+        } else if (ch < 0x20) {
+            std::ostringstream hex;
+            hex << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(ch);
+            out += hex.str();
+        } else {
+            out += static_cast<char>(ch);
+        }
+    }
+    return out;
+}
+
+// Екранування поля CSV (лапки подвоюються)
+static std::string csv_escape(const std::string &s) {
+    std::string out = "\"";
+    for (char ch : s) {
+        if (ch == '"') out += '"';
+        out += ch;
+    }
+    return out + "\"";
+}
+
+// Компактний запис розв'язаної сітки
+static std::string encode_solution(const grid &solved) {
+    std::string out;
+    out.reserve(solved.rows() * (solved.cols() + 1));
+    for (int r = 0; r < solved.rows(); ++r) {
+        if (r) out += '/';
+        for (int c = 0; c < solved.cols(); ++c)
+            out += solved.at(r, c) == nurikabe_solver::BLACK ? '1' : '0';
+    }
+    return out;
+}
+
+// Формування рядка результату
+static std::string format_line(output_format format, long long id, const std::string &status,
+                               double time_ms, const std::string &payload) {
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3);
+    if (format == output_format::JSONL) {
+        line << "{\"id\":" << id << ",\"status\":\"" << status << "\",\"time_ms\":" << time_ms;
+        if (status == "solved") line << ",\"solution\":\"" << payload << "\"";
+        else if (status == "error" || status == "interrupted") line << ",\"message\":\"" << json_escape(payload) << "\"";
+        line << "}";
+    } else {
+        line << id << "," << status << "," << time_ms << ",";
+        if (status == "solved") line << payload;
+        else if (status == "error" || status == "interrupted") line << csv_escape(payload);
+    }
+    return line.str();
+}
+
+// Розв'язання одного завдання
+static std::string run_job(nurikabe_solver &solver, const batch_job &job, output_format format) {
+    if (job.bad) return format_line(format, job.id, "error", 0, job.error);
+
+    auto start = std::chrono::steady_clock::now();
+    std::string status, payload;
+    try {
+        // Проміжні кроки не зберігаються: усі зміни накладаються на одну сітку
+        grid solved = job.puzzle;
+        solver.solve(job.puzzle, [&](const nurikabe_solver::solve_step &step) {
+            nurikabe_solver::apply_step(solved, step);
+        });
+        status = "solved";
+        payload = encode_solution(solved);
+    } catch (const solve_interrupted &e) {
+        status = "interrupted";
+        payload = e.what();
+    } catch (const std::runtime_error &) {
+        status = "unsolvable";
+    } catch (const std::exception &e) {
+        status = "error";
+        payload = e.what();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return format_line(format, job.id, status, elapsed.count(), payload);
+}
+
+// Віддає готовий рядок і виводить усі рядки, для яких готові попередні
+static void publish(batch_state &state, long long id, std::string line, std::ostream &out) {
+    std::lock_guard<std::mutex> guard(state.lock);
+    state.ready.emplace(id, std::move(line));
+    bool advanced = false;
+    for (auto it = state.ready.begin(); it != state.ready.end() && it->first == state.next_output;
+         it = state.ready.erase(it)) {
+        out << it->second << '\n';
+        ++state.next_output;
+        advanced = true;
+    }
+    if (advanced) {
+        out.flush();
+        state.window_free.notify_all();
+    }
+}
+
+// Цикл робочого потоку
+static void worker_loop(batch_state &state, output_format format, double time_limit, long long node_limit,
+                        nurikabe_solver::engine engine, std::ostream &out) {
+    nurikabe_solver solver;
+    solver.set_time_limit(time_limit);
+    solver.set_node_limit(node_limit);
+    solver.set_engine(engine);
+    while (true) {
+        batch_job job;
+        {
+            std::unique_lock<std::mutex> guard(state.lock);
+            state.job_ready.wait(guard, [&] { return !state.jobs.empty() || state.input_done; });
+            if (state.jobs.empty()) return;
+            job = std::move(state.jobs.front());
+            state.jobs.pop_front();
+        }
+        publish(state, job.id, run_job(solver, job, format), out);
+    }
+}
+
+// Передача завдання пулу
+static void submit(batch_state &state, batch_job job, long long window) {
+    {
+        // Між найстаршою невиведеною сіткою і новою не більше window сіток — пам'ять обмежена
+        std::unique_lock<std::mutex> guard(state.lock);
+        state.window_free.wait(guard, [&] { return job.id - state.next_output < window; });
+        state.jobs.push_back(std::move(job));
+    }
+    state.job_ready.notify_one();
+}
+
+// Читання всіх сіток з потоку і передача їх пулу
+static void feed(std::istream &in, batch_state &state, long long &next_id, long long window) {
+    // Зіпсована сітка не зупиняє обробку: читач сам пропускає її залишок до порожнього рядка
+    grid_stream stream(in);
+    for (const parsed_grid &parsed : stream) {
+        batch_job job;
+        if (parsed.ok()) {
+            job.puzzle = parsed.data.grid;
+        } else {
+            job.bad = true;
+            job.error = parsed.error + " (рядок " + std::to_string(parsed.line) + ", стовпець " +
+                        std::to_string(parsed.column) + ")";
+        }
+        job.id = next_id++;
+        submit(state, std::move(job), window);
+    }
+}
+
+// Передача пулу всіх сіток бінарного корпусу
+static void feed_corpus(const corpus_reader &reader, batch_state &state, long long &next_id, long long window) {
+    for (std::size_t n = 0; n < reader.size(); ++n) {
+        batch_job job;
+        try {
+            job.puzzle = reader.at(n).to_grid();
+        } catch (const std::runtime_error &e) {
+            job.bad = true;
+            job.error = e.what();
+        }
+        job.id = next_id++;
+        submit(state, std::move(job), window);
+    }
+}
+
+// Підказка щодо використання
+static void usage(std::ostream &out) {
+    out << "Використання: nurikabe_batch [-j потоки] [--format jsonl|csv] [--time-limit секунди] [--node-limit вузли]\n"
+        << "                             [--engine native|sat] [файл ...]\n"
+        << "Без файлів або з файлом \"-\" сітки читаються з stdin\n";
+}
+
+int main(int argc, char **argv) {
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    output_format format = output_format::JSONL;
+    double time_limit = 0;
+    long long node_limit = 0;
+    nurikabe_solver::engine engine = nurikabe_solver::engine::NATIVE;
+    std::vector<std::string> files;
+
+    // Розбір аргументів командного рядка
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "-j" || arg == "--threads") && i + 1 < argc) {
+            int n = std::atoi(argv[++i]);
+            if (n <= 0) {
+                std::cerr << "Кількість потоків має бути додатною\n";
+                return 2;
+            }
+            threads = static_cast<unsigned>(n);
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "jsonl") format = output_format::JSONL;
+            else if (name == "csv") format = output_format::CSV;
+            else {
+                std::cerr << "Невідомий формат: " << name << "\n";
+                return 2;
+            }
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            time_limit = std::atof(argv[++i]);
+            if (time_limit <= 0) {
+                std::cerr << "Обмеження часу має бути додатним\n";
+                return 2;
+            }
+        } else if (arg == "--node-limit" && i + 1 < argc) {
+            node_limit = std::atoll(argv[++i]);
+            if (node_limit <= 0) {
+                std::cerr << "Обмеження кількості вузлів має бути додатним\n";
+                return 2;
+            }
+        } else if (arg == "--engine" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "native") engine = nurikabe_solver::engine::NATIVE;
+            else if (name == "sat") engine = nurikabe_solver::engine::SAT;
+            else {
+                std::cerr << "Невідомий рушій: " << name << "\n";
+                return 2;
+            }
+        } else if (arg == "-h" || arg == "--help") {
+            usage(std::cout);
+            return 0;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Невідомий параметр: " << arg << "\n";
+            usage(std::cerr);
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) files.push_back("-");
+
+    std::ios::sync_with_stdio(false);
+    if (format == output_format::CSV) std::cout << "id,status,time_ms,solution\n";
+
+    batch_state state;
+    long long window = 64LL * threads;
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i)
+        pool.emplace_back(worker_loop, std::ref(state), format, time_limit, node_limit, engine, std::ref(std::cout));
+
+    // id сіток наскрізні для всіх файлів
+    long long next_id = 1;
+    int exit_code = 0;
+    for (const std::string &file : files) {
+        if (file == "-") {
+            feed(std::cin, state, next_id, window);
+            continue;
+        }
+        if (puzzle_corpus::is_corpus(file)) {
+            try {
+                corpus_reader reader(file);
+                feed_corpus(reader, state, next_id, window);
+            } catch (const std::runtime_error &e) {
+                std::cerr << e.what() << "\n";
+                exit_code = 1;
+            }
+            continue;
+        }
+        std::ifstream fin(file, std::ios::binary);
+        if (!fin) {
+            std::cerr << "Не вдалося відкрити " << file << "\n";
+            exit_code = 1;
+            continue;
+        }
+        feed(fin, state, next_id, window);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.input_done = true;
+    }
+    state.job_ready.notify_all();
+    for (auto &t : pool) t.join();
+    std::cout.flush();
+
+    return exit_code;
+}
@@ -0,0 +1,226 @@
+// nurikabe_bench.cpp
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include "grid_reader.hpp"
+#include "nurikabe_solver.hpp"
+#include "user_solution_checker.hpp"
+
+/*
+    Мікробенчмарки окремих примітивів розв'язувача на фіксованих синтетичних сітках 10x10 … 100x100.
+    Для кожної операції виводиться час (нс/оп) і кількість виділень пам'яті (виділень/оп).
+
+    Використання: nurikabe_bench [фільтр] — запускає лише операції, назва яких містить фільтр
+*/
+
+// Лічильник виділень пам'яті: глобальний operator new цієї програми рахує кожен виклик
+static std::atomic<long long> allocations{0};
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using grid = flat_grid;
+
+/*
+    Синтетична розв'язана сітка n x n: непарні рядки повністю чорні, у парних рядках чорна кожна
+    четверта клітинка (стовпці 3, 7, …). Острови — відрізки парних рядків довжиною до 3 з числом посередині.
+    Чорні клітинки парних рядків не мають чорних сусідів у рядку, тож квадратів 2x2 немає, а чорна область зв'язна
+*/
+static grid make_solution(int n) {
+    grid g(n, n);
+    for (int r = 0; r < n; ++r)
+        for (int c = 0; c < n; ++c)
+            g.at(r, c) = (r % 2 == 1 || c % 4 == 3) ? nurikabe_solver::BLACK : nurikabe_solver::FILLED;
+
+    for (int r = 0; r < n; r += 2) {
+        for (int c0 = 0; c0 < n; c0 += 4) {
+            int len = std::min(3, n - c0);
+            g.at(r, c0 + len / 2) = len;
+        }
+    }
+    return g;
+}
+
+// Головоломка для синтетичної сітки — лише числа
+static grid make_puzzle(const grid &solution) {
+    grid g(solution.rows(), solution.cols());
+    for (int r = 0; r < g.rows(); ++r)
+        for (int c = 0; c < g.cols(); ++c)
+            if (solution.at(r, c) > 0) g.at(r, c) = solution.at(r, c);
+    return g;
+}
+
+// Доступ до приватних примітивів (оголошено friend у nurikabe_solver і user_solution_checker)
+struct nurikabe_bench {
+    // Готує робочий стан розв'язувача для головоломки, як на початку solve
+    static void prepare(nurikabe_solver &s, const grid &puzzle) {
+        s.prepare(puzzle);
+    }
+
+    // Переводить робочий стан у розв'язану сітку через журнал змін
+    static void fill_solution(nurikabe_solver &s, const grid &solution) {
+        for (int id = 0; id < solution.size(); ++id) {
+            if (solution[id] != flat_grid::BORDER && solution[id] <= 0 && s.grid_[id] != solution[id])
+                s.set_cell(id, solution[id]);
+        }
+    }
+
+    // Число в середині сітки
+    static int middle_clue(const nurikabe_solver &s) {
+        int best = -1;
+        int target = s.size_ / 2;
+        for (int id = 0; id < s.size_; ++id)
+            if (s.grid_[id] > 0 && (best < 0 || std::abs(id - target) < std::abs(best - target))) best = id;
+        return best;
+    }
+
+    static size_t find_paths(nurikabe_solver &s, int clue) {
+        return s.find_all_valid_paths(clue, s.grid_[clue]).size();
+    }
+    static bool connected(const nurikabe_solver &s) { return s.is_black_area_connected(); }
+    static bool full_black_window(const nurikabe_solver &s) { return s.has_full_black_window(); }
+
+    /*
+        Запис рядка row (у розв'язаній синтетичній сітці непарні рядки повністю чорні) заповненими клітинками
+        з подальшим відкатом: set_cell і undo_to разом з лічильниками вікон 2×2, як у вузлі пошуку
+    */
+    static long long set_row_and_undo(nurikabe_solver &s, int row) {
+        size_t mark = s.trail_.size();
+        for (int c = 0; c < s.grid_.cols(); ++c) s.set_cell(s.grid_.index(row, c), nurikabe_solver::FILLED);
+        long long windows = s.full_windows_;
+        s.undo_to(mark);
+        return windows;
+    }
+
+    // Фарбування межі області з подальшим відкатом, щоб кожна ітерація починалась з того самого стану
+    static void paint_and_undo(nurikabe_solver &s, const nurikabe_solver::Path &path) {
+        size_t mark = s.trail_.size();
+        s.paint_adjacent(path);
+        s.undo_to(mark);
+    }
+    static nurikabe_solver::Path first_path(nurikabe_solver &s, int clue) {
+        auto paths = s.find_all_valid_paths(clue, s.grid_[clue]);
+        return paths.empty() ? nurikabe_solver::Path() : paths.front();
+    }
+
+    static void load_checker(user_solution_checker &checker, const grid &solution) {
+        checker.user_grid_ = solution;
+    }
+    static bool validate(user_solution_checker &checker, std::ostream &out) {
+        return checker.validation_phase(out);
+    }
+};
+
+// Запобігає видаленню обчислень оптимізатором
+static volatile long long sink = 0;
+
+// Вимірювання однієї операції: повторює її, поки не набереться щонайменше MIN_TIME
+static void measure(const std::string &name, int n, const std::string &filter, const std::function<long long()> &op) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+    using clock = std::chrono::steady_clock;
+    const std::chrono::duration<double> MIN_TIME(0.2);
+
+    // Розігрів
+    sink += op();
+
+    long long iterations = 0;
+    long long allocs_before = allocations.load();
+    auto start = clock::now();
+    std::chrono::duration<double> elapsed(0);
+    long long batch = 1;
+    while (elapsed < MIN_TIME) {
+        for (long long i = 0; i < batch; ++i) sink += op();
+        iterations += batch;
+        batch *= 2;
+        elapsed = clock::now() - start;
+    }
+    long long allocs = allocations.load() - allocs_before;
+
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(4) << n << "x" << std::left << std::setw(5) << n
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << elapsed.count() * 1e9 / iterations << " ns/op"
+              << std::setprecision(2) << std::setw(10) << double(allocs) / iterations << " allocs/op\n";
+}
+
+int main(int argc, char **argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    const int sizes[] = { 10, 25, 50, 100 };
+
+    std::cout << "Операція                    Розмір              Час          Виділення\n";
+    for (int n : sizes) {
+        grid solution = make_solution(n);
+        grid puzzle = make_puzzle(solution);
+
+        // Стан на початку пошуку: перебір областей і фарбування межі
+        nurikabe_solver root;
+        nurikabe_bench::prepare(root, puzzle);
+        int clue = nurikabe_bench::middle_clue(root);
+        nurikabe_solver::Path path = nurikabe_bench::first_path(root, clue);
+
+        measure("find_all_valid_paths", n, filter, [&] { return (long long)nurikabe_bench::find_paths(root, clue); });
+        measure("paint_adjacent+undo", n, filter, [&] { nurikabe_bench::paint_and_undo(root, path); return 0LL; });
+
+        /*
+            Повністю розв'язаний стан: перевірка зв'язності проходить усю сітку, а квадрати 2x2 пошук бачить
+            за лічильниками вікон, які оновлює кожен set_cell, тож вимірюються запис з відкатом і сама перевірка
+        */
+        nurikabe_solver solved;
+        nurikabe_bench::prepare(solved, puzzle);
+        nurikabe_bench::fill_solution(solved, solution);
+        measure("is_black_area_connected", n, filter, [&] { return (long long)nurikabe_bench::connected(solved); });
+        measure("set_cell+undo_to (row)", n, filter, [&] { return nurikabe_bench::set_row_and_undo(solved, 1); });
+        measure("has_full_black_window", n, filter, [&] { return (long long)nurikabe_bench::full_black_window(solved); });
+
+        // Зчитування з файлу
+        std::string path_name = (std::filesystem::temp_directory_path() /
+                                 ("nurikabe_bench_" + std::to_string(n) + ".txt")).string();
+        {
+            std::ofstream out(path_name);
+            out << n << " " << n << "\n";
+            for (int r = 0; r < n; ++r) {
+                for (int c = 0; c < n; ++c) out << puzzle.at(r, c) << (c + 1 < n ? " " : "\n");
+            }
+        }
+        measure("grid_reader::from_file", n, filter, [&] { return (long long)grid_reader::from_file(path_name).rows; });
+        std::remove(path_name.c_str());
+
+        // Перевірка рішення користувача без фази зчитування
+        user_solution_checker checker(puzzle);
+        nurikabe_bench::load_checker(checker, solution);
+        std::ostream null_out(nullptr);
+        measure("user_solution_checker", n, filter, [&] { return (long long)nurikabe_bench::validate(checker, null_out); });
+
+        // Потокова перевірка того самого рішення рядок за рядком
+        std::vector<int> clue_row(n), solution_row(n);
+        measure("streaming_solution_checker", n, filter, [&] {
+            streaming_solution_checker streaming(n);
+            for (int r = 0; r < n; ++r) {
+                for (int c = 0; c < n; ++c) {
+                    clue_row[c] = puzzle.at(r, c);
+                    solution_row[c] = solution.at(r, c);
+                }
+                streaming.push_row(clue_row.data(), solution_row.data());
+            }
+            return (long long)streaming.finish().ok();
+        });
+    }
+
+    return 0;
+}
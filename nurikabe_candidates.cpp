@@ -0,0 +1,144 @@
+// nurikabe_candidates.cpp
+#include "nurikabe_solver.hpp"
+#include <algorithm>
+
+/*
+    Списки варіантів областей для nurikabe_solver. Варіант стає недопустимим, коли клітинка його області
+    стала чорною або заповненою іншим островом, або коли клітинка його межі стала заповненою чи білою
+    (її вже не можна пофарбувати в чорний). Кожна така клітинка збільшує kills варіанту на одиницю,
+    тож варіант знову стає допустимим, щойно всі ці зміни відкочено
+*/
+
+// Чи забороняє значення клітинки мати її всередині області
+static bool blocks_member(int value) {
+    return value == nurikabe_solver::BLACK || value == nurikabe_solver::FILLED;
+}
+
+// Чи забороняє значення клітинки мати її на межі області
+static bool blocks_halo(int value) {
+    return value == nurikabe_solver::FILLED || value == nurikabe_solver::WHITE;
+}
+
+// Метод для побудови списків варіантів для всіх невикористаних чисел
+void nurikabe_solver::build_candidates() {
+    candidates_.clear();
+    cand_cells_.clear();
+    listed_clues_.clear();
+    clue_begin_.assign(size_, -1);
+    clue_end_.assign(size_, -1);
+    alive_.assign(size_, 0);
+
+    for (int id = 0; id < size_; ++id) {
+        if (grid_[id] <= 0 || used_[id]) continue;
+
+        // Для числа у відкритому просторі список був би завеликим — воно й далі перебирається щоразу
+        if (count_valid_paths(id, grid_[id], CANDIDATE_LIMIT + 1) > CANDIDATE_LIMIT) continue;
+
+        clue_begin_[id] = static_cast<int>(candidates_.size());
+        for (const Path &path : find_all_valid_paths(id, grid_[id])) {
+            candidate cand{ id, 0, static_cast<int>(cand_cells_.size()), 0, 0 };
+            cand_cells_.insert(cand_cells_.end(), path.begin(), path.end());
+            cand.mid = static_cast<int>(cand_cells_.size());
+
+            // Межа — сусіди області без повторів; рамка та числа ніколи не змінюються, тож їх не зберігаємо
+            unsigned halo = next_stamp();
+            for (int idx : path) visit_mark_[idx] = halo;
+            for (int idx : path) {
+                for (int d = 0; d < 4; ++d) {
+                    int nid = idx + dir_[d];
+                    if (visit_mark_[nid] == halo || grid_[nid] == flat_grid::BORDER || grid_[nid] > 0) continue;
+                    visit_mark_[nid] = halo;
+                    cand_cells_.push_back(nid);
+                }
+            }
+            cand.end = static_cast<int>(cand_cells_.size());
+            candidates_.push_back(cand);
+        }
+        clue_end_[id] = static_cast<int>(candidates_.size());
+        listed_clues_.push_back(id);
+    }
+
+    // Обернені індекси клітинка -> варіанти у стиснутому вигляді (зсуви + суцільний масив)
+    member_start_.assign(size_ + 1, 0);
+    halo_start_.assign(size_ + 1, 0);
+    for (const candidate &cand : candidates_) {
+        for (int k = cand.begin + 1; k < cand.mid; ++k) ++member_start_[cand_cells_[k] + 1];
+        for (int k = cand.mid; k < cand.end; ++k) ++halo_start_[cand_cells_[k] + 1];
+    }
+    for (int id = 0; id < size_; ++id) {
+        member_start_[id + 1] += member_start_[id];
+        halo_start_[id + 1] += halo_start_[id];
+    }
+    member_list_.resize(member_start_[size_]);
+    halo_list_.resize(halo_start_[size_]);
+    std::vector<int> member_pos(member_start_.begin(), member_start_.end() - 1);
+    std::vector<int> halo_pos(halo_start_.begin(), halo_start_.end() - 1);
+
+    for (int k = 0; k < static_cast<int>(candidates_.size()); ++k) {
+        candidate &cand = candidates_[k];
+        for (int i = cand.begin + 1; i < cand.mid; ++i) {
+            int id = cand_cells_[i];
+            member_list_[member_pos[id]++] = k;
+            if (blocks_member(grid_[id])) ++cand.kills;
+        }
+        for (int i = cand.mid; i < cand.end; ++i) {
+            int id = cand_cells_[i];
+            halo_list_[halo_pos[id]++] = k;
+            if (blocks_halo(grid_[id])) ++cand.kills;
+        }
+        if (cand.kills == 0) ++alive_[cand.clue];
+    }
+
+    candidates_ready_ = true;
+}
+
+// Метод для оновлення лічильників варіантів при зміні клітинки id (викликається з write_cell)
+void nurikabe_solver::update_candidates(int id, int old_value, int value) {
+    auto bump = [&](int k, int delta) {
+        candidate &cand = candidates_[k];
+        if (delta > 0) {
+            if (cand.kills++ == 0) --alive_[cand.clue];
+        } else {
+            if (--cand.kills == 0) ++alive_[cand.clue];
+        }
+    };
+
+    int member_delta = blocks_member(value) - blocks_member(old_value);
+    if (member_delta) {
+        for (int i = member_start_[id]; i < member_start_[id + 1]; ++i) bump(member_list_[i], member_delta);
+    }
+    int halo_delta = blocks_halo(value) - blocks_halo(old_value);
+    if (halo_delta) {
+        for (int i = halo_start_[id]; i < halo_start_[id + 1]; ++i) bump(halo_list_[i], halo_delta);
+    }
+}
+
+// Метод для отримання допустимих областей числа
+std::vector<nurikabe_solver::Path> nurikabe_solver::candidate_paths(int clue) {
+    if (!candidates_ready_ || clue_begin_[clue] < 0) return find_all_valid_paths(clue, grid_[clue]);
+
+    // Порядок варіантів збігається з порядком перебору, тож пошук проходить гілки так само, як і без списків
+    std::vector<Path> result;
+    result.reserve(alive_[clue]);
+    for (int k = clue_begin_[clue]; k < clue_end_[clue]; ++k) {
+        const candidate &cand = candidates_[k];
+        if (cand.kills == 0)
+            result.emplace_back(cand_cells_.begin() + cand.begin, cand_cells_.begin() + cand.mid);
+    }
+    return result;
+}
+
+// Метод для підрахунку допустимих областей числа з обмеженням limit
+int nurikabe_solver::candidate_count(int clue, int limit) {
+    if (!candidates_ready_ || clue_begin_[clue] < 0) return count_valid_paths(clue, grid_[clue], limit);
+    return std::min(alive_[clue], limit);
+}
+
+// Метод для перевірки, чи не залишилося числа без жодного варіанту
+bool nurikabe_solver::has_dead_clue() const {
+    if (!candidates_ready_) return false;
+    for (int id : listed_clues_) {
+        if (!used_[id] && alive_[id] == 0) return true;
+    }
+    return false;
+}
@@ -0,0 +1,125 @@
+// nurikabe_corpus.cpp
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "grid_reader.hpp"
+#include "puzzle_corpus.hpp"
+
+/*
+    Перетворення між текстовим форматом input.txt і бінарним корпусом задач (puzzle_corpus.hpp).
+
+    Використання:
+        nurikabe_corpus pack -o корпус [файл ...]   — текст → корпус (без файлів або з "-" читається stdin)
+        nurikabe_corpus unpack корпус [-o файл]     — корпус → текст (типово у stdout)
+        nurikabe_corpus info корпус                 — кількість задач і розміри перших з них
+*/
+
+// Підказка щодо використання
+static void usage(std::ostream &out) {
+    out << "Використання:\n"
+        << "  nurikabe_corpus pack -o корпус [файл ...]\n"
+        << "  nurikabe_corpus unpack корпус [-o файл]\n"
+        << "  nurikabe_corpus info корпус\n";
+}
+
+// Додає всі сітки з потоку до корпусу; зіпсована сітка зупиняє перетворення, бо зсунула б номери решти
+static void pack_stream(std::istream &in, const std::string &name, corpus_writer &writer) {
+    grid_stream stream(in);
+    for (const parsed_grid &parsed : stream) {
+        if (!parsed.ok()) {
+            throw std::runtime_error(name + ", сітка " + std::to_string(parsed.number) + " (рядок " +
+                                     std::to_string(parsed.line) + ", стовпець " + std::to_string(parsed.column) +
+                                     "): " + parsed.error);
+        }
+        writer.add(parsed.data.grid);
+    }
+}
+
+// Текст → корпус
+static int pack(const std::string &output, std::vector<std::string> files) {
+    if (files.empty()) files.push_back("-");
+    corpus_writer writer(output);
+    for (const std::string &file : files) {
+        if (file == "-") {
+            pack_stream(std::cin, "stdin", writer);
+            continue;
+        }
+        std::ifstream fin(file, std::ios::binary);
+        if (!fin) throw std::runtime_error("Не вдалося відкрити " + file);
+        pack_stream(fin, file, writer);
+    }
+    writer.finish();
+    std::cerr << "Записано " << writer.size() << " задач у " << output << "\n";
+    return 0;
+}
+
+// Корпус → текст
+static int unpack(const std::string &input, const std::string &output) {
+    corpus_reader reader(input);
+    std::ofstream fout;
+    if (!output.empty()) {
+        fout.open(output);
+        if (!fout) throw std::runtime_error("Не вдалося відкрити " + output);
+    }
+    std::ostream &out = output.empty() ? std::cout : fout;
+
+    for (std::size_t n = 0; n < reader.size(); ++n) {
+        corpus_puzzle puzzle = reader.at(n);
+        if (n) out << "\n";
+        out << puzzle.rows << " " << puzzle.cols << "\n";
+        for (int r = 0; r < puzzle.rows; ++r) {
+            for (int c = 0; c < puzzle.cols; ++c) out << puzzle.at(r, c) << (c + 1 < puzzle.cols ? " " : "\n");
+        }
+    }
+    return 0;
+}
+
+// Короткі відомості про корпус
+static int info(const std::string &input) {
+    corpus_reader reader(input);
+    std::cout << "Задач: " << reader.size() << "\n";
+    for (std::size_t n = 0; n < reader.size() && n < 5; ++n) {
+        corpus_puzzle puzzle = reader.at(n);
+        std::cout << "  " << n << ": " << puzzle.rows << "x" << puzzle.cols << ", " << puzzle.cell_bits << " біт на клітинку\n";
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage(std::cerr);
+        return 2;
+    }
+    std::string command = argv[1];
+    if (command == "-h" || command == "--help") {
+        usage(std::cout);
+        return 0;
+    }
+
+    // Розбір аргументів командного рядка
+    std::string output;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (arg.size() > 1 && arg[0] == '-') {
+            std::cerr << "Невідомий параметр: " << arg << "\n";
+            usage(std::cerr);
+            return 2;
+        } else files.push_back(arg);
+    }
+
+    try {
+        if (command == "pack" && !output.empty()) return pack(output, files);
+        if (command == "unpack" && files.size() == 1) return unpack(files[0], output);
+        if (command == "info" && files.size() == 1) return info(files[0]);
+    } catch (const std::runtime_error &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    usage(std::cerr);
+    return 2;
+}
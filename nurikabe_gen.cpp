@@ -0,0 +1,323 @@
+// nurikabe_gen.cpp
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include "nurikabe_solver.hpp"
+
+/*
+    Генератор головоломок з єдиним рішенням. Для кожної задачі будується випадкове розфарбування-рішення:
+    чорна область росте від однієї клітинки без квадратів 2x2, поки не займе потрібну частку сітки і поки
+    всі білі острови не стануть не більшими за max-island. У кожен острів ставиться число, що дорівнює його розміру,
+    і розв'язувач перевіряє єдиність (count_solutions з межею 2). Якщо рішень кілька, розфарбування ремонтується:
+    одна з клітинок, які інше рішення робить чорними, стає чорною і в задуманому, а числа змінених островів
+    перераховуються. Якщо ремонт не вдається або перевірка перевищує обмеження вузлів (--check-nodes, за замовчуванням
+    CHECK_NODE_LIMIT), береться нове розфарбування.
+
+    Задача з номером i залежить лише від зерна і i, тож вивід відтворюваний за будь-якої кількості потоків.
+
+    Використання: nurikabe_gen [-n кількість] [-r рядки] [-c стовпці] [-j потоки] [--seed зерно]
+                               [--max-island розмір] [--check-nodes вузли] [-o файл]
+    Задачі виводяться у форматі input.txt, розділені порожнім рядком
+*/
+
+using grid = flat_grid;
+
+// Параметри генерації
+struct gen_options {
+    int count = 10;
+    int rows = 10;
+    int cols = 10;
+    int max_island = 6;
+    long long check_nodes = 0;   // обмеження вузлів перевірки єдиності (0 — CHECK_NODE_LIMIT)
+    std::uint64_t seed = 0;
+};
+
+// Скільки разів ремонтувати одне розфарбування, перш ніж побудувати нове
+static constexpr int REPAIR_TRIES = 32;
+
+/*
+    Обмеження вузлів для однієї перевірки єдиності за замовчуванням. Задачі, для яких друге рішення шукається довше,
+    відкидаються разом з розфарбуванням: нове розфарбування зазвичай перевіряється швидше, ніж довга перевірка
+    доходить до кінця. Тому більше обмеження не окуповується навіть на великих сітках: на 15x15 і 20x20 генерація
+    з 250 вузлами втричі швидша, ніж з 2000, а з 8000 — ще вчетверо повільніша; на 10x10 різниці немає.
+    Обмежуються саме вузли, а не час, щоб результат не залежав від навантаження машини
+*/
+static constexpr long long CHECK_NODE_LIMIT = 250;
+
+// Перемішування зерна (splitmix64): сусідні номери задач дають незалежні генератори
+static std::uint64_t mix_seed(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Чи утворить чорна клітинка id квадрат 2x2 з уже чорними
+static bool closes_black_2x2(const grid &g, int id) {
+    const int s = g.stride();
+    const int corners[4] = { id - s - 1, id - s, id - 1, id };
+    for (int top_left : corners) {
+        int black = 0;
+        for (int cell : { top_left, top_left + 1, top_left + s, top_left + s + 1 })
+            black += cell == id || g[cell] == nurikabe_solver::BLACK;
+        if (black == 4) return true;
+    }
+    return false;
+}
+
+// Розмітка білих островів: номер острова для кожної клітинки (-1 — чорна або рамка), списки клітинок островів
+static void label_islands(const grid &g, std::vector<int> &island, std::vector<std::vector<int>> &cells) {
+    const int dir[4] = { -g.stride(), g.stride(), -1, 1 };
+    island.assign(g.size(), -1);
+    cells.clear();
+    for (int id = 0; id < g.size(); ++id) {
+        if (g[id] != nurikabe_solver::EMPTY || island[id] >= 0) continue;
+        int label = static_cast<int>(cells.size());
+        cells.emplace_back(1, id);
+        island[id] = label;
+        for (size_t head = 0; head < cells[label].size(); ++head) {
+            int cur = cells[label][head];
+            for (int d : dir) {
+                int nid = cur + d;
+                if (g[nid] != nurikabe_solver::EMPTY || island[nid] >= 0) continue;
+                island[nid] = label;
+                cells[label].push_back(nid);
+            }
+        }
+    }
+}
+
+/*
+    Випадкове розфарбування-рішення: BLACK — чорні клітинки, EMPTY — білі. Чорна область зв'язна, бо росте
+    лише сусідніми клітинками. false — рости далі нікуди, а острови ще завеликі (спроба повторюється)
+*/
+static bool make_layout(const gen_options &opt, std::mt19937_64 &rng, grid &layout) {
+    layout = grid(opt.rows, opt.cols);
+    const int dir[4] = { -layout.stride(), layout.stride(), -1, 1 };
+    const int cells = opt.rows * opt.cols;
+    // Частка чорних клітинок у задачах зазвичай трохи більша за половину
+    const int target = static_cast<int>(cells * std::uniform_real_distribution<double>(0.50, 0.62)(rng));
+
+    layout.at(std::uniform_int_distribution<int>(0, opt.rows - 1)(rng),
+              std::uniform_int_distribution<int>(0, opt.cols - 1)(rng)) = nurikabe_solver::BLACK;
+    int black = 1;
+
+    std::vector<int> island;
+    std::vector<std::vector<int>> islands;
+    std::vector<int> options;
+    while (true) {
+        // Досягнувши потрібної частки, чорнимо лише клітинки завеликих островів
+        std::vector<char> oversized;
+        if (black >= target) {
+            label_islands(layout, island, islands);
+            oversized.assign(islands.size(), 0);
+            bool any = false;
+            for (size_t i = 0; i < islands.size(); ++i) {
+                if (static_cast<int>(islands[i].size()) > opt.max_island) oversized[i] = any = true;
+            }
+            if (!any) return black < cells;
+        }
+
+        options.clear();
+        for (int id = 0; id < layout.size(); ++id) {
+            if (layout[id] != nurikabe_solver::EMPTY) continue;
+            if (!oversized.empty() && !oversized[island[id]]) continue;
+            bool touches = false;
+            for (int d : dir) touches |= layout[id + d] == nurikabe_solver::BLACK;
+            if (touches && !closes_black_2x2(layout, id)) options.push_back(id);
+        }
+        if (options.empty()) return false;
+
+        layout[options[std::uniform_int_distribution<size_t>(0, options.size() - 1)(rng)]] = nurikabe_solver::BLACK;
+        ++black;
+    }
+}
+
+/*
+    Розставляє числа островів розфарбування layout. Острів, що містить число попередньої задачі previous,
+    зберігає його клітинку, інші отримують число на випадковій клітинці
+*/
+static grid place_clues(const grid &layout, const grid &previous, std::mt19937_64 &rng) {
+    std::vector<int> island;
+    std::vector<std::vector<int>> islands;
+    label_islands(layout, island, islands);
+
+    grid puzzle(layout.rows(), layout.cols());
+    for (const auto &cells : islands) {
+        int clue = -1;
+        for (int id : cells)
+            if (previous.size() == puzzle.size() && previous[id] > 0) clue = id;
+        if (clue < 0) clue = cells[std::uniform_int_distribution<size_t>(0, cells.size() - 1)(rng)];
+        puzzle[clue] = static_cast<int>(cells.size());
+    }
+    return puzzle;
+}
+
+// Генерація однієї задачі з єдиним рішенням
+static grid generate(const gen_options &opt, std::uint64_t index, nurikabe_solver &solver) {
+    std::mt19937_64 rng(mix_seed(opt.seed ^ mix_seed(index)));
+    const grid none;
+    grid layout, puzzle, other;
+    std::vector<int> options;
+
+    while (true) {
+        if (!make_layout(opt, rng, layout)) continue;
+        puzzle = place_clues(layout, none, rng);
+        const int dir[4] = { -layout.stride(), layout.stride(), -1, 1 };
+
+        for (int attempt = 0; attempt < REPAIR_TRIES; ++attempt) {
+            // Розфарбування є рішенням за побудовою, тож рішень щонайменше одне; запам'ятовуємо інше, якщо воно є
+            bool ambiguous = false;
+            auto keep_other = [&](const grid &solution) {
+                for (int id = 0; id < layout.size(); ++id) {
+                    if ((layout[id] == nurikabe_solver::BLACK) != (solution[id] == nurikabe_solver::BLACK)) {
+                        other = solution;
+                        ambiguous = true;
+                        return;
+                    }
+                }
+            };
+            int found;
+            try {
+                found = solver.count_solutions(puzzle, 2, keep_other);
+            } catch (const solve_interrupted &) {
+                break;
+            }
+            if (found == 1) return puzzle;
+            if (!ambiguous) break;
+
+            /*
+                Ремонт: клітинка, біла в задуманому рішенні й чорна в іншому, стає чорною і в задуманому.
+                Острів зменшується або розпадається, його числа змінюються, тож інше рішення перестає підходити.
+                Чорна область лишається зв'язною, бо клітинка має чорного сусіда
+            */
+            options.clear();
+            for (int id = 0; id < layout.size(); ++id) {
+                if (layout[id] != nurikabe_solver::EMPTY || other[id] != nurikabe_solver::BLACK) continue;
+                bool touches = false;
+                for (int d : dir) touches |= layout[id + d] == nurikabe_solver::BLACK;
+                if (touches && !closes_black_2x2(layout, id)) options.push_back(id);
+            }
+            if (options.empty()) break;
+            layout[options[std::uniform_int_distribution<size_t>(0, options.size() - 1)(rng)]] = nurikabe_solver::BLACK;
+            puzzle = place_clues(layout, puzzle, rng);
+        }
+    }
+}
+
+// Запис задачі у форматі input.txt
+static std::string format_puzzle(const grid &puzzle) {
+    std::ostringstream out;
+    out << puzzle.rows() << " " << puzzle.cols() << "\n";
+    for (int r = 0; r < puzzle.rows(); ++r) {
+        for (int c = 0; c < puzzle.cols(); ++c) out << puzzle.at(r, c) << (c + 1 < puzzle.cols() ? " " : "\n");
+    }
+    return out.str();
+}
+
+// Спільний стан потоків: наступний номер задачі і готові задачі, що чекають на попередні
+struct gen_state {
+    std::atomic<int> next{0};
+    std::mutex lock;
+    std::map<int, std::string> ready;
+    int next_output = 0;
+};
+
+// Цикл робочого потоку
+static void worker_loop(const gen_options &opt, gen_state &state, std::ostream &out) {
+    nurikabe_solver solver;
+    solver.set_node_limit(opt.check_nodes);
+    for (int index = state.next++; index < opt.count; index = state.next++) {
+        std::string text = format_puzzle(generate(opt, static_cast<std::uint64_t>(index), solver));
+
+        // Виводимо задачі в порядку номерів, щойно готові всі попередні
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.ready.emplace(index, std::move(text));
+        for (auto it = state.ready.begin(); it != state.ready.end() && it->first == state.next_output;
+             it = state.ready.erase(it)) {
+            if (state.next_output) out << "\n";
+            out << it->second;
+            ++state.next_output;
+        }
+    }
+}
+
+// Підказка щодо використання
+static void usage(std::ostream &out) {
+    out << "Використання: nurikabe_gen [-n кількість] [-r рядки] [-c стовпці] [-j потоки] [--seed зерно]\n"
+        << "                           [--max-island розмір] [--check-nodes вузли] [-o файл]\n";
+}
+
+int main(int argc, char **argv) {
+    gen_options opt;
+    opt.seed = std::random_device()();
+    unsigned threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    std::string output;
+
+    // Розбір аргументів командного рядка
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if ((arg == "-n" || arg == "--count") && has_value) opt.count = std::atoi(argv[++i]);
+        else if ((arg == "-r" || arg == "--rows") && has_value) opt.rows = std::atoi(argv[++i]);
+        else if ((arg == "-c" || arg == "--cols") && has_value) opt.cols = std::atoi(argv[++i]);
+        else if ((arg == "-j" || arg == "--threads") && has_value) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--seed" && has_value) opt.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max-island" && has_value) opt.max_island = std::atoi(argv[++i]);
+        else if (arg == "--check-nodes" && has_value) opt.check_nodes = std::atoll(argv[++i]);
+        else if (arg == "-o" && has_value) output = argv[++i];
+        else if (arg == "-h" || arg == "--help") {
+            usage(std::cout);
+            return 0;
+        } else {
+            std::cerr << "Невідомий параметр: " << arg << "\n";
+            usage(std::cerr);
+            return 2;
+        }
+    }
+    if (opt.count < 0 || opt.rows < 2 || opt.cols < 2 || opt.max_island < 1 || opt.check_nodes < 0 || threads == 0) {
+        std::cerr << "Кількість задач, розміри сітки, розмір острова, обмеження вузлів і кількість потоків мають бути додатними"
+                     " (сітка — щонайменше 2x2)\n";
+        return 2;
+    }
+    if (opt.check_nodes == 0) opt.check_nodes = CHECK_NODE_LIMIT;
+
+    std::ofstream fout;
+    if (!output.empty()) {
+        fout.open(output);
+        if (!fout) {
+            std::cerr << "Не вдалося відкрити " << output << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = output.empty() ? std::cout : fout;
+
+    // Зерно виводиться, щоб запуск можна було повторити
+    std::cerr << "Зерно: " << opt.seed << "\n";
+    auto start = std::chrono::steady_clock::now();
+
+    gen_state state;
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < threads; ++i)
+        pool.emplace_back(worker_loop, std::cref(opt), std::ref(state), std::ref(out));
+    for (auto &t : pool) t.join();
+    out.flush();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "Згенеровано " << opt.count << " задач " << opt.rows << "x" << opt.cols << " за "
+              << std::fixed << std::setprecision(2) << elapsed.count() << " с ("
+              << std::setprecision(0) << (elapsed.count() > 0 ? opt.count * 60.0 / elapsed.count() : 0) << " задач/хв)\n";
+    return 0;
+}
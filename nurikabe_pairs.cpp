@@ -7,12 +7,12 @@
 #include "nurikabe_solver.hpp"
 #include "user_solution_checker.hpp"
 
-using grid = std::vector<std::vector<int>>;
+using grid = flat_grid;
 
 // Вивід довільної сітки у консолі
 void display(const grid &grid) {
-    int rows = grid.size();
-    int cols = rows ? grid[0].size() : 0;
+    int rows = grid.rows();
+    int cols = grid.cols();
 
     const std::string horizontal = "───";
     const std::string corner_tl = "┌", corner_tr = "┐";
@@ -29,7 +29,7 @@ void display(const grid &grid) {
     for (int r = 0; r < rows; ++r) {
         std::cout << vertical;
         for (int c = 0; c < cols; ++c) {
-            int v = grid[r][c];
+            int v = grid.at(r, c);
             if (v == nurikabe_solver::FILLED)
                 std::cout << " #";
             else if (v == nurikabe_solver::BLACK)
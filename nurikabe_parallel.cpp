@@ -0,0 +1,251 @@
+// nurikabe_parallel.cpp
+#include "nurikabe_solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+/*
+    Паралельний пошук для nurikabe_solver. Гілка пошуку задається префіксом — списком областей від кореня,
+    тож потік, який її забрав, просто повторює ці області на своїй копії розв'язувача і шукає далі сам.
+    Гілки з'являються лише тоді, коли є вільний потік: зайнятий потік віддає йому ще не спробовані
+    області свого поточного вузла. Кожен потік має свою чергу: власні гілки бере з кінця (найглибші),
+    чужі забирає з початку (найближчі до кореня, тобто найбільші)
+*/
+struct nurikabe_solver::parallel_search {
+    using task = std::vector<Path>;
+
+    // Черга гілок одного потоку
+    struct worker_queue {
+        std::mutex lock;
+        std::deque<task> tasks;
+    };
+
+    explicit parallel_search(unsigned threads) : queues(threads) {}
+
+    std::vector<worker_queue> queues;
+    std::atomic<int> queued{0};      // кількість гілок у всіх чергах
+    std::atomic<int> pending{0};     // кількість гілок, які ще не перевірені до кінця (в черзі або в роботі)
+    std::atomic<int> idle{0};        // кількість потоків, що чекають на роботу
+    std::atomic<bool> stop{false};   // рішення знайдено або пошук перервано — решта потоків завершується
+    std::atomic<long long> nodes{0}; // сумарна кількість вузлів усіх потоків (рахується лише з обмеженням вузлів)
+    std::atomic<int> interrupt{-1};  // причина переривання (solve_interrupted::reason) або -1
+
+    std::mutex result_lock;
+    bool found = false;
+    task solution;                   // усі області рішення в порядку від кореня
+
+    // Додає гілку в чергу потоку owner
+    void push(unsigned owner, task t) {
+        pending.fetch_add(1);
+        std::lock_guard<std::mutex> guard(queues[owner].lock);
+        queues[owner].tasks.push_back(std::move(t));
+        queued.fetch_add(1);
+    }
+
+    // Бере гілку зі своєї черги, а якщо вона порожня — з інших
+    bool pop(unsigned owner, task &t) {
+        if (queued.load() == 0) return false;
+        for (unsigned k = 0; k < queues.size(); ++k) {
+            unsigned victim = (owner + k) % queues.size();
+            std::lock_guard<std::mutex> guard(queues[victim].lock);
+            auto &tasks = queues[victim].tasks;
+            if (tasks.empty()) continue;
+            if (victim == owner) {
+                t = std::move(tasks.back());
+                tasks.pop_back();
+            } else {
+                t = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            queued.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+};
+
+// Паралельний варіант solve
+std::vector<nurikabe_solver::grid> nurikabe_solver::solve_parallel(const grid initial, unsigned threads) {
+    std::vector<grid> res;
+    grid current = initial;
+    solve_parallel(initial, [&](const solve_step &step) {
+        apply_step(current, step);
+        res.push_back(current);
+    }, threads);
+    return res;
+}
+
+// Паралельний варіант solve з передачею кроків обробнику
+void nurikabe_solver::solve_parallel(const grid initial, const step_callback &on_step, unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 1 || engine_ == engine::SAT) {
+        solve(initial, on_step);
+        return;
+    }
+    start_limits();
+    if (solve_small(initial, on_step)) return;
+
+    if (stats_) stats_->reset();
+    stat_timer timer(stats_, &solver_stats::time_total);
+
+    // Висновки в корені спільні для всіх потоків, тож суперечність тут означає, що рішення немає взагалі
+    if (!prepare(initial)) {
+        release();
+        throw std::runtime_error("Рішення не існує");
+    }
+
+    parallel_search shared(threads);
+    shared.push(0, parallel_search::task());
+
+    // Допоміжні потоки готують власні копії розв'язувача, основний працює як потік 0
+    std::vector<nurikabe_solver> helpers(threads - 1);
+    // Статистику кожен потік збирає окремо, а після завершення вона додається до основної
+    std::vector<solver_stats> helper_stats(stats_ ? threads - 1 : 0);
+    // Обмеження спільні для всіх потоків: той самий момент завершення і сумарний лічильник вузлів
+    for (nurikabe_solver &helper : helpers) {
+        helper.time_limit_ = time_limit_;
+        helper.node_limit_ = node_limit_;
+        helper.cancel_ = cancel_;
+        helper.limits_active_ = limits_active_;
+        helper.deadline_ = deadline_;
+    }
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+        pool.emplace_back([&shared, &helpers, &helper_stats, &initial, i]() {
+            nurikabe_solver &helper = helpers[i - 1];
+            if (!helper_stats.empty()) helper.set_stats(&helper_stats[i - 1]);
+            if (helper.prepare(initial)) helper.run_worker(shared, i);
+            helper.release();
+        });
+    }
+    run_worker(shared, 0);
+    for (auto &t : pool) t.join();
+    for (const solver_stats &stats : helper_stats) stats_->merge(stats);
+
+    if (!shared.found) {
+        release();
+        // Якщо якийсь потік перервав пошук, перебір неповний і відсутність рішення не доведено
+        if (shared.interrupt.load() >= 0) {
+            interrupted_ = true;
+            interrupt_reason_ = static_cast<solve_interrupted::reason>(shared.interrupt.load());
+        }
+        throw_if_interrupted();
+        throw std::runtime_error("Рішення не існує");
+    }
+
+    // Складаємо області рішення так само, як їх залишає solve_recurse: від найглибшої до кореня
+    solution_cells_.clear();
+    solution_ends_.clear();
+    for (auto it = shared.solution.rbegin(); it != shared.solution.rend(); ++it)
+        push_solution(*it);
+
+    recover_step_by_step(on_step);
+    release();
+}
+
+// Метод для роботи одного потоку паралельного пошуку
+void nurikabe_solver::run_worker(parallel_search &shared, unsigned index) {
+    shared_ = &shared;
+    worker_ = index;
+
+    // Стан після висновків у корені, до якого потік повертається після кожної гілки
+    size_t base = trail_.size();
+    parallel_search::task t;
+    bool waiting = false;
+
+    while (!shared.stop.load()) {
+        if (!shared.pop(index, t)) {
+            // Усі гілки перевірено і нових не буде — рішення немає
+            if (shared.pending.load() == 0) break;
+            if (!waiting) {
+                waiting = true;
+                shared.idle.fetch_add(1);
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        if (waiting) {
+            waiting = false;
+            shared.idle.fetch_sub(1);
+        }
+
+        // Повторюємо області префікса; якщо якась з них уже суперечлива — гілка неправильна
+        bool ok = true;
+        for (const Path &path : t) {
+            if (!apply_region(path)) {
+                ok = false;
+                break;
+            }
+            decisions_.push_back(&path);
+        }
+
+        if (ok && solve_recurse()) {
+            std::lock_guard<std::mutex> guard(shared.result_lock);
+            if (!shared.found) {
+                shared.found = true;
+                shared.solution = t;
+                for (size_t k = solution_ends_.size(); k-- > 0;) {
+                    int begin = k ? solution_ends_[k - 1] : 0;
+                    shared.solution.emplace_back(solution_cells_.begin() + begin,
+                                                 solution_cells_.begin() + solution_ends_[k]);
+                }
+            }
+            shared.stop.store(true);
+        }
+
+        // Відкочуємо гілку до стану кореня
+        undo_to(base);
+        for (int id : slot_clue_)
+            if (used_[id]) set_used(id, 0);
+        decisions_.clear();
+        solution_cells_.clear();
+        solution_ends_.clear();
+        shared.pending.fetch_sub(1);
+    }
+
+    if (waiting) shared.idle.fetch_sub(1);
+    shared_ = nullptr;
+}
+
+// Метод для передачі неперевірених областей поточного вузла вільним потокам
+bool nurikabe_solver::poll_parallel(std::vector<Path> &paths, size_t next) {
+    if (shared_->stop.load(std::memory_order_relaxed)) return false;
+    if (next >= paths.size() || shared_->idle.load(std::memory_order_relaxed) == 0) return true;
+
+    // Кожна віддана область стає окремою гілкою з префіксом поточного вузла
+    for (size_t i = next; i < paths.size(); ++i) {
+        parallel_search::task t;
+        t.reserve(decisions_.size() + 1);
+        for (const Path *path : decisions_) t.push_back(*path);
+        t.push_back(std::move(paths[i]));
+        shared_->push(worker_, std::move(t));
+    }
+    paths.resize(next);
+    return true;
+}
+
+// Метод для перевірки обмежень у вузлі пошуку
+bool nurikabe_solver::within_limits() {
+    using reason = solve_interrupted::reason;
+
+    // У паралельному режимі обмеження вузлів стосується суми по всіх потоках
+    long long nodes = nodes_;
+    if (node_limit_ > 0 && shared_) nodes = shared_->nodes.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    if (node_limit_ > 0 && nodes > node_limit_) interrupt_reason_ = reason::NODE_LIMIT;
+    else if (cancel_ && cancel_->load(std::memory_order_relaxed)) interrupt_reason_ = reason::CANCELLED;
+    else if (time_limit_ > 0 && std::chrono::steady_clock::now() >= deadline_) interrupt_reason_ = reason::TIME_LIMIT;
+    else return true;
+
+    // Решта потоків зупиняється так само, як після знайденого рішення; зберігається перша причина
+    interrupted_ = true;
+    if (shared_) {
+        int none = -1;
+        shared_->interrupt.compare_exchange_strong(none, static_cast<int>(interrupt_reason_));
+        shared_->stop.store(true);
+    }
+    return false;
+}
@@ -0,0 +1,185 @@
+// nurikabe_propagation.cpp
+#include "nurikabe_solver.hpp"
+#include <algorithm>
+
+/*
+    Поширення обмежень для nurikabe_solver: стандартні логічні правила Нурікабе, що виконуються
+    до нерухомої точки в кожному вузлі пошуку. Зміни робляться лише через set_cell,
+    тож відкат гілки в solve_recurse скасовує і всі висновки
+*/
+
+// Метод для застосування всіх правил, поки вони щось змінюють
+bool nurikabe_solver::propagate() {
+    while (true) {
+        size_t before = trail_.size();
+        new_white_.clear();
+
+        if (!mark_unreachable_black()) return false;
+        if (!wall_finished_islands()) return false;
+        escape_black_2x2();
+        if (!extend_black_walls()) return false;
+
+        // Висновки могли замкнути чорний квадрат 2x2
+        if (has_full_black_window()) return false;
+
+        // Нові білі клітинки прибрали частину можливих чорних, перевіряємо зв'язність лише навколо них
+        if (!new_white_.empty() && !is_black_area_still_connected(new_white_)) return false;
+
+        // Жодне правило нічого не змінило — нерухому точку досягнуто
+        if (trail_.size() == before) break;
+    }
+    return true;
+}
+
+// Метод для фарбування клітинок, до яких не дотягується жодна область
+bool nurikabe_solver::mark_unreachable_black() {
+    /*
+        Клітинка, сусідня з двома різними числами, не проходить is_expandable для жодного з них,
+        тому правило "клітинка між двома підказками — чорна" теж покривається цим проходом.
+        Недосяжні вікна 2x2 одразу стають повністю чорними, і propagate відкидає такий стан
+    */
+    refresh_reach_maps();
+    for (int id = 0; id < size_; ++id) {
+        if (cover_[id]) continue;
+        if (grid_[id] == EMPTY) set_cell(id, BLACK);
+        // Біла клітинка, якої не може досягти жоден острів — суперечність
+        else if (grid_[id] == WHITE) return false;
+    }
+    return true;
+}
+
+// Метод для обгородження островів, які вже мають потрібну кількість білих клітинок
+bool nurikabe_solver::wall_finished_islands() {
+    for (int id = 0; id < size_; ++id) {
+        if (grid_[id] <= 0 || used_[id]) continue;
+
+        // Збираємо число разом з білими клітинками, з'єднаними з ним
+        unsigned visit = next_stamp();
+        int head = 0, tail = 0;
+        bfs_queue_[tail++] = id;
+        visit_mark_[id] = visit;
+        while (head < tail) {
+            int u = bfs_queue_[head++];
+            for (int d = 0; d < 4; ++d) {
+                int nid = u + dir_[d];
+                if (visit_mark_[nid] == visit || grid_[nid] != WHITE) continue;
+                visit_mark_[nid] = visit;
+                bfs_queue_[tail++] = nid;
+            }
+        }
+
+        // Острів уже більший за число — суперечність, рівний — всі порожні сусіди чорні
+        if (tail > grid_[id]) return false;
+        if (tail < grid_[id]) continue;
+        for (int k = 0; k < tail; ++k) {
+            for (int d = 0; d < 4; ++d) {
+                int nid = bfs_queue_[k] + dir_[d];
+                if (grid_[nid] == EMPTY) set_cell(nid, BLACK);
+            }
+        }
+    }
+    return true;
+}
+
+// Метод для пошуку вікон 2x2 з трьома чорними клітинками і порожньою четвертою
+void nurikabe_solver::escape_black_2x2() {
+    for (int w = 0; w < size_; ++w) {
+        if (window_black_[w] != 3) continue;
+        const int corners[4] = { w, w + dir_[3], w + dir_[1], w + dir_[1] + dir_[3] };
+        for (int id : corners) {
+            // Вікна, що зачіпають рамку, теж можуть мати три чорні клітинки, але рамка не порожня
+            if (grid_[id] == EMPTY) {
+                set_cell(id, WHITE);
+                new_white_.push_back(id);
+            }
+        }
+    }
+}
+
+// Метод для продовження чорних областей з єдиним виходом
+bool nurikabe_solver::extend_black_walls() {
+    int total_black = 0;
+    for (int id = 0; id < size_; ++id)
+        if (grid_[id] == BLACK) ++total_black;
+
+    /*
+        Кожну чорну область обходимо в ширину й рахуємо її порожніх сусідів.
+        Якщо поза областю є інші чорні клітинки, область мусить вийти до них через порожнього сусіда:
+        без сусідів — суперечність, з одним — він обов'язково чорний.
+        Вимушені клітинки фарбуємо після проходу, щоб не змінювати області, які ще не переглянуті
+    */
+    forced_.clear();
+    unsigned comp = next_stamp();
+    for (int id = 0; id < size_; ++id) {
+        if (grid_[id] != BLACK || visit_mark_[id] == comp) continue;
+
+        int head = 0, tail = 0;
+        bfs_queue_[tail++] = id;
+        visit_mark_[id] = comp;
+        int liberty = -1;
+        bool many = false;
+        while (head < tail) {
+            int u = bfs_queue_[head++];
+            for (int d = 0; d < 4; ++d) {
+                int nid = u + dir_[d];
+                if (grid_[nid] == EMPTY) {
+                    if (liberty < 0) liberty = nid;
+                    else if (liberty != nid) many = true;
+                    continue;
+                }
+                if (grid_[nid] != BLACK || visit_mark_[nid] == comp) continue;
+                visit_mark_[nid] = comp;
+                bfs_queue_[tail++] = nid;
+            }
+        }
+
+        if (tail == total_black || many) continue;
+        if (liberty < 0) return false;
+        forced_.push_back(liberty);
+    }
+
+    for (int id : forced_) {
+        if (grid_[id] == EMPTY) set_cell(id, BLACK);
+    }
+    return true;
+}
+
+// Метод для розбору частин, на які розпалися чорні та порожні клітинки
+bool nurikabe_solver::resolve_open_pockets() {
+    /*
+        Усі чорні клітинки мають лежати в одній частині. Частини без жодної чорної клітинки
+        вже не зможуть з'єднатися з рештою, тому всі їх клітинки мусять стати білими.
+        Поки чорних клітинок немає взагалі, будь-яка частина може виявитися тією єдиною
+    */
+    int black_parts = 0;
+    forced_.clear();
+    unsigned comp = next_stamp();
+    for (int id = 0; id < size_; ++id) {
+        if ((grid_[id] != BLACK && grid_[id] != EMPTY) || visit_mark_[id] == comp) continue;
+
+        int head = 0, tail = 0;
+        bfs_queue_[tail++] = id;
+        visit_mark_[id] = comp;
+        bool has_black = false;
+        while (head < tail) {
+            int u = bfs_queue_[head++];
+            if (grid_[u] == BLACK) has_black = true;
+            for (int d = 0; d < 4; ++d) {
+                int nid = u + dir_[d];
+                if (visit_mark_[nid] == comp || (grid_[nid] != BLACK && grid_[nid] != EMPTY)) continue;
+                visit_mark_[nid] = comp;
+                bfs_queue_[tail++] = nid;
+            }
+        }
+
+        if (has_black) {
+            if (++black_parts > 1) return false;
+        } else {
+            forced_.insert(forced_.end(), bfs_queue_.begin(), bfs_queue_.begin() + tail);
+        }
+    }
+
+    if (black_parts == 0) return true;
+    for (int id : forced_) set_cell(id, WHITE);
+    return true;
+}
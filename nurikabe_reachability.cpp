@@ -0,0 +1,107 @@
+// nurikabe_reachability.cpp
+#include "nurikabe_solver.hpp"
+#include <algorithm>
+
+/*
+    Карти досяжності для nurikabe_solver. Для кожного числа зберігається відстань (у кроках по допустимих
+    клітинках) до всіх клітинок, які може охопити його область, тобто на відстані не більше числа - 1.
+    Допустимість клітинки залежить лише від того, чи вона чорна, тому карту числа позначаємо застарілою,
+    коли чорною стає клітинка з карти або перестає бути чорною будь-яка клітинка з кореневої карти,
+    а також коли число стає використаним чи звільняється. Застарілі карти перебудовуються лише при зверненні.
+    cover_ рахує, скільки невикористаних чисел досягають клітинки, за актуальними картами
+*/
+
+// Метод для побудови карт досяжності всіх чисел у корені пошуку
+void nurikabe_solver::build_reach_maps() {
+    reach_ready_ = false;
+    clue_slot_.assign(size_, -1);
+    slot_clue_.clear();
+    for (int id = 0; id < size_; ++id) {
+        if (grid_[id] > 0) {
+            clue_slot_[id] = static_cast<int>(slot_clue_.size());
+            slot_clue_.push_back(id);
+        }
+    }
+
+    int slots = static_cast<int>(slot_clue_.size());
+    reach_dist_.assign(slots, std::vector<int>(size_, -1));
+    reach_cells_.assign(slots, std::vector<int>());
+    reach_dirty_.assign(slots, 1);
+    cover_.assign(size_, 0);
+    for (int slot = 0; slot < slots; ++slot) refresh_reach(slot);
+
+    /*
+        Надалі чорних клітинок на гілці лише більшає, а при відкаті стан не стає вільнішим за кореневий,
+        тож кожна карта завжди лежить всередині кореневої. Обернений індекс клітинка -> карти будуємо по ній
+    */
+    near_start_.assign(size_ + 1, 0);
+    for (int slot = 0; slot < slots; ++slot)
+        for (int id : reach_cells_[slot]) ++near_start_[id + 1];
+    for (int id = 0; id < size_; ++id) near_start_[id + 1] += near_start_[id];
+    near_list_.resize(near_start_[size_]);
+    std::vector<int> pos(near_start_.begin(), near_start_.end() - 1);
+    for (int slot = 0; slot < slots; ++slot)
+        for (int id : reach_cells_[slot]) near_list_[pos[id]++] = slot;
+
+    reach_ready_ = true;
+}
+
+// Метод для перебудови карти досяжності одного числа пошуком у ширину
+void nurikabe_solver::refresh_reach(int slot) {
+    std::vector<int> &dist = reach_dist_[slot];
+    std::vector<int> &cells = reach_cells_[slot];
+
+    // Знімаємо внесок старої карти, скидаючи лише клітинки, які вона містила
+    for (int id : cells) {
+        dist[id] = -1;
+        --cover_[id];
+    }
+    cells.clear();
+    reach_dirty_[slot] = 0;
+
+    int start = slot_clue_[slot];
+    if (used_[start]) return;
+
+    // Список клітинок карти одночасно є чергою обходу
+    int total_size = grid_[start];
+    dist[start] = 0;
+    cells.push_back(start);
+    for (size_t head = 0; head < cells.size(); ++head) {
+        int id = cells[head];
+        if (dist[id] + 1 >= total_size) continue;
+        for (int d = 0; d < 4; ++d) {
+            int nid = id + dir_[d];
+            if (dist[nid] >= 0 || !is_expandable(nid, start)) continue;
+            dist[nid] = dist[id] + 1;
+            cells.push_back(nid);
+        }
+    }
+    for (int id : cells) ++cover_[id];
+}
+
+// Метод для перебудови всіх застарілих карт
+void nurikabe_solver::refresh_reach_maps() {
+    for (int slot = 0; slot < static_cast<int>(slot_clue_.size()); ++slot)
+        if (reach_dirty_[slot]) refresh_reach(slot);
+}
+
+// Метод для позначення застарілих карт при зміні клітинки id (викликається з write_cell)
+void nurikabe_solver::touch_reach(int id, int old_value, int value) {
+    if ((old_value == BLACK) == (value == BLACK)) return;
+    for (int i = near_start_[id]; i < near_start_[id + 1]; ++i) {
+        int slot = near_list_[i];
+        // Нова чорна клітинка змінює лише ті карти, які її містять; звільнена — будь-яку з кореневих
+        if (value != BLACK || reach_dist_[slot][id] >= 0) reach_dirty_[slot] = 1;
+    }
+}
+
+// Метод для зміни позначки використаного числа разом з його картою
+void nurikabe_solver::set_used(int clue, char value) {
+    used_[clue] = value;
+    if (reach_ready_) reach_dirty_[clue_slot_[clue]] = 1;
+}
+
+// Метод для перевірки, чи може клітинка id увійти в область числа clue (карта має бути актуальною)
+bool nurikabe_solver::in_reach(int clue, int id) const {
+    return reach_dist_[clue_slot_[clue]][id] >= 0;
+}
@@ -0,0 +1,397 @@
+// nurikabe_sat.cpp
+#include "nurikabe_solver.hpp"
+#include "sat_solver.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/*
+    Альтернативний рушій: задача кодується в CNF і розв'язується вбудованим CDCL-розв'язувачем (sat_solver.hpp).
+
+    Змінні: white[id] — клітинка біла; own[k][id] — клітинка належить острову числа k. Острів числа k може
+    містити лише клітинки на відстані до значення - 1 від числа, що не є іншими числами і не сусідять з ними.
+    Клаузи:
+    - біла клітинка належить рівно одному острову, клітинка острова біла;
+    - біла сусідка клітинки острова k теж належить острову k (різні острови не торкаються);
+    - у кожному вікні 2x2 є біла клітинка;
+    - острів k має рівно значення клітинок (послідовний лічильник);
+    - острів k зв'язний: reach[k][t][id] — клітинка острова з'єднана з числом шляхом довжини не більше t
+      по клітинках острова; кожна клітинка острова досяжна за значення - 1 кроків;
+    - якщо чорних клітинок щонайменше дві, у кожної чорної є чорна сусідка.
+    Зв'язність чорної області кодувалася б квадратичною кількістю змінних, тож вона додається ліниво:
+    якщо знайдений набір має кілька чорних частин, для кожної додається клауза "ця частина не може бути
+    замкнена білою межею, поки поза нею є чорна клітинка", і пошук продовжується з уже навченим
+*/
+struct sat_encoding {
+    sat_solver sat;
+    int size = 0;                           // розмір сітки разом з рамкою
+    int dir[4] = { 0, 0, 0, 0 };
+    std::vector<int> cells;                 // клітинки поля (без рамки)
+    std::vector<int> white;                 // змінна "клітинка біла" (size, -1 для рамки)
+    std::vector<int> clue_cells;            // клітинки з числами
+    std::vector<int> clue_values;
+    std::vector<std::vector<int>> own;      // змінна "клітинка належить острову k" (size, -1 — не може належати)
+    std::vector<std::vector<int>> dist;     // відстань від числа k у межах його можливого острова або -1
+
+    explicit sat_encoding(const flat_grid &puzzle);
+
+    // Додає всі клаузи; false — формула точно невиконувана
+    bool encode(const flat_grid &puzzle);
+
+    // Додає клаузи зв'язності чорної області для знайденого набору; false — чорна область уже зв'язна
+    bool add_black_cuts();
+
+private:
+    std::vector<int> lits_;                 // буфер клаузи
+
+    int lit(int var, bool value) const { return value ? sat_solver::positive(var) : sat_solver::negative(var); }
+
+    // Можливі клітинки острова числа k (пошук у ширину)
+    void build_area(int k, const std::vector<char> &blocked);
+
+    // Не більше однієї істинної серед змінних vars (попарно або послідовно для довгих списків)
+    bool at_most_one(const std::vector<int> &vars);
+
+    // Рівно count істинних серед змінних vars (послідовний лічильник)
+    bool exactly(const std::vector<int> &vars, int count);
+
+    // Клаузи зв'язності острова k
+    bool island_connected(int k);
+};
+
+// Конструктор: змінна "біла" для кожної клітинки поля
+sat_encoding::sat_encoding(const flat_grid &puzzle) {
+    size = puzzle.size();
+    dir[0] = -puzzle.stride();
+    dir[1] = puzzle.stride();
+    dir[2] = -1;
+    dir[3] = 1;
+    white.assign(size, -1);
+    for (int r = 0; r < puzzle.rows(); ++r) {
+        for (int c = 0; c < puzzle.cols(); ++c) {
+            int id = puzzle.index(r, c);
+            cells.push_back(id);
+            white[id] = sat.new_var();
+            if (puzzle[id] > 0) {
+                clue_cells.push_back(id);
+                clue_values.push_back(puzzle[id]);
+            }
+        }
+    }
+}
+
+// Метод для побудови можливого острова числа k
+void sat_encoding::build_area(int k, const std::vector<char> &blocked) {
+    std::vector<int> &d = dist[k];
+    d.assign(size, -1);
+    int start = clue_cells[k];
+    d[start] = 0;
+    std::vector<int> queue{ start };
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        int id = queue[head];
+        if (d[id] + 1 >= clue_values[k]) continue;
+        for (int delta : dir) {
+            int nid = id + delta;
+            if (white[nid] < 0 || blocked[nid] || d[nid] >= 0) continue;
+            d[nid] = d[id] + 1;
+            queue.push_back(nid);
+        }
+    }
+}
+
+// Метод для обмеження "не більше однієї"
+bool sat_encoding::at_most_one(const std::vector<int> &vars) {
+    if (vars.size() <= 6) {
+        for (std::size_t i = 0; i < vars.size(); ++i)
+            for (std::size_t j = i + 1; j < vars.size(); ++j)
+                if (!sat.add_clause({ lit(vars[i], false), lit(vars[j], false) })) return false;
+        return true;
+    }
+    // Послідовне кодування: prefix[i] — серед перших i + 1 змінних є істинна
+    int prev = -1;
+    for (std::size_t i = 0; i < vars.size(); ++i) {
+        int prefix = sat.new_var();
+        if (!sat.add_clause({ lit(vars[i], false), lit(prefix, true) })) return false;
+        if (prev >= 0) {
+            if (!sat.add_clause({ lit(prev, false), lit(prefix, true) }) ||
+                !sat.add_clause({ lit(prev, false), lit(vars[i], false) })) return false;
+        }
+        prev = prefix;
+    }
+    return true;
+}
+
+// Метод для обмеження "рівно count"
+bool sat_encoding::exactly(const std::vector<int> &vars, int count) {
+    int n = static_cast<int>(vars.size());
+    if (count > n) return sat.add_clause({});
+
+    /*
+        at[j] після i-ї змінної — серед перших i + 1 змінних щонайменше j + 1 істинних (j < count + 1).
+        Рекурентність at_i[j] <-> at_{i-1}[j] or (at_{i-1}[j - 1] and x_i) кодується в обидва боки,
+        наприкінці at[count - 1] істинна, а at[count] — хибна
+    */
+    int width = count + 1;
+    std::vector<int> prev(width, -1), next(width, -1);   // -1 — стала "хиба"
+    for (int i = 0; i < n; ++i) {
+        int x = vars[i];
+        for (int j = 0; j < width && j <= i; ++j) {
+            int v = sat.new_var();
+            next[j] = v;
+            int below = j == 0 ? -2 : prev[j - 1];     // -2 — стала "істина" (нуль істинних є завжди)
+            // at_{i-1}[j] -> v
+            if (prev[j] >= 0 && !sat.add_clause({ lit(prev[j], false), lit(v, true) })) return false;
+            // at_{i-1}[j - 1] and x -> v
+            if (below == -2) {
+                if (!sat.add_clause({ lit(x, false), lit(v, true) })) return false;
+            } else if (below >= 0) {
+                if (!sat.add_clause({ lit(below, false), lit(x, false), lit(v, true) })) return false;
+            }
+            // v -> at_{i-1}[j] or at_{i-1}[j - 1]
+            lits_.clear();
+            lits_.push_back(lit(v, false));
+            if (prev[j] >= 0) lits_.push_back(lit(prev[j], true));
+            if (below >= 0) lits_.push_back(lit(below, true));
+            if (below != -2 && !sat.add_clause(lits_)) return false;
+            // v -> at_{i-1}[j] or x
+            lits_.clear();
+            lits_.push_back(lit(v, false));
+            if (prev[j] >= 0) lits_.push_back(lit(prev[j], true));
+            lits_.push_back(lit(x, true));
+            if (!sat.add_clause(lits_)) return false;
+        }
+        std::swap(prev, next);
+    }
+    if (count > 0 && (prev[count - 1] < 0 || !sat.add_clause({ lit(prev[count - 1], true) }))) return false;
+    return prev[count] < 0 || sat.add_clause({ lit(prev[count], false) });
+}
+
+// Метод для клауз зв'язності острова k
+bool sat_encoding::island_connected(int k) {
+    const std::vector<int> &d = dist[k];
+    int value = clue_values[k], start = clue_cells[k];
+    if (value == 1) return true;
+
+    // reach[id] для поточного t; у числа досяжність завжди істинна, тому для нього змінної немає
+    std::vector<int> prev(size, -1), next(size, -1);
+    for (int t = 1; t < value; ++t) {
+        for (int id : cells) {
+            next[id] = -1;
+            if (id == start || d[id] < 0 || d[id] > t) continue;
+            int v = sat.new_var();
+            next[id] = v;
+            if (!sat.add_clause({ lit(v, false), lit(own[k][id], true) })) return false;
+
+            // Досяжна за t кроків — значить, вона або сусідка досяжна за t - 1
+            lits_.clear();
+            lits_.push_back(lit(v, false));
+            bool near_clue = false;
+            if (prev[id] >= 0) lits_.push_back(lit(prev[id], true));
+            for (int delta : dir) {
+                int nid = id + delta;
+                if (nid == start) near_clue = true;
+                else if (prev[nid] >= 0) lits_.push_back(lit(prev[nid], true));
+            }
+            if (!near_clue && !sat.add_clause(lits_)) return false;
+        }
+        std::swap(prev, next);
+    }
+    for (int id : cells) {
+        if (id == start || d[id] < 0) continue;
+        if (!sat.add_clause({ lit(own[k][id], false), lit(prev[id], true) })) return false;
+    }
+    return true;
+}
+
+// Метод для побудови всієї формули
+bool sat_encoding::encode(const flat_grid &puzzle) {
+    int clue_count = static_cast<int>(clue_cells.size());
+
+    // Клітинки, що сусідять з числом, не можуть належати острову іншого числа
+    std::vector<int> near_clue(size, -1);   // число-сусід клітинки, -2 — сусідів-чисел кілька
+    for (int k = 0; k < clue_count; ++k) {
+        for (int delta : dir) {
+            int nid = clue_cells[k] + delta;
+            if (white[nid] < 0) continue;
+            near_clue[nid] = near_clue[nid] == -1 ? k : -2;
+        }
+    }
+
+    own.assign(clue_count, std::vector<int>());
+    dist.assign(clue_count, std::vector<int>());
+    std::vector<char> blocked(size, 0);
+    for (int k = 0; k < clue_count; ++k) {
+        for (int id : cells) blocked[id] = (puzzle[id] > 0 && id != clue_cells[k]) || (near_clue[id] >= 0 && near_clue[id] != k) ||
+                                         near_clue[id] == -2 || puzzle[id] == nurikabe_solver::BLACK;
+        build_area(k, blocked);
+        own[k].assign(size, -1);
+        for (int id : cells)
+            if (dist[k][id] >= 0) own[k][id] = sat.new_var();
+        if (!sat.add_clause({ lit(own[k][clue_cells[k]], true) })) return false;
+    }
+
+    // Власник білої клітинки; позначки початкової сітки
+    long long white_total = 0;
+    for (int value : clue_values) white_total += value;
+    std::vector<int> owners;
+    for (int id : cells) {
+        owners.clear();
+        lits_.clear();
+        lits_.push_back(lit(white[id], false));
+        for (int k = 0; k < clue_count; ++k) {
+            if (own[k][id] < 0) continue;
+            owners.push_back(own[k][id]);
+            lits_.push_back(lit(own[k][id], true));
+            if (!sat.add_clause({ lit(own[k][id], false), lit(white[id], true) })) return false;
+        }
+        if (!sat.add_clause(lits_) || !at_most_one(owners)) return false;
+
+        int value = puzzle[id];
+        if (value > 0 || value == nurikabe_solver::FILLED || value == nurikabe_solver::WHITE) {
+            if (!sat.add_clause({ lit(white[id], true) })) return false;
+        } else if (value == nurikabe_solver::BLACK) {
+            if (!sat.add_clause({ lit(white[id], false) })) return false;
+        }
+    }
+
+    // Біла сусідка клітинки острова k належить тому ж острову
+    for (int k = 0; k < clue_count; ++k) {
+        for (int id : cells) {
+            if (own[k][id] < 0) continue;
+            for (int delta : dir) {
+                int nid = id + delta;
+                if (white[nid] < 0) continue;
+                if (own[k][nid] < 0) {
+                    if (!sat.add_clause({ lit(own[k][id], false), lit(white[nid], false) })) return false;
+                } else if (!sat.add_clause({ lit(own[k][id], false), lit(white[nid], false), lit(own[k][nid], true) })) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Вікна 2x2
+    for (int id : cells) {
+        int right = id + dir[3], down = id + dir[1], corner = down + dir[3];
+        if (white[right] < 0 || white[down] < 0) continue;
+        if (!sat.add_clause({ lit(white[id], true), lit(white[right], true), lit(white[down], true), lit(white[corner], true) }))
+            return false;
+    }
+
+    // Розміри і зв'язність островів
+    std::vector<int> vars;
+    for (int k = 0; k < clue_count; ++k) {
+        vars.clear();
+        for (int id : cells)
+            if (own[k][id] >= 0) vars.push_back(own[k][id]);
+        if (!exactly(vars, clue_values[k]) || !island_connected(k)) return false;
+    }
+
+    // Чорних клітинок стільки, скільки лишається після островів; дві й більше — кожна має чорну сусідку
+    long long black_total = static_cast<long long>(cells.size()) - white_total;
+    if (black_total < 0) return sat.add_clause({});
+    if (black_total >= 2) {
+        for (int id : cells) {
+            lits_.clear();
+            lits_.push_back(lit(white[id], true));
+            for (int delta : dir)
+                if (white[id + delta] >= 0) lits_.push_back(lit(white[id + delta], false));
+            if (!sat.add_clause(lits_)) return false;
+        }
+    }
+    return true;
+}
+
+// Метод для лінивих клауз зв'язності чорної області
+bool sat_encoding::add_black_cuts() {
+    // Розмітка чорних частин знайденого набору
+    std::vector<int> part(size, -1);
+    std::vector<std::vector<int>> parts;
+    for (int id : cells) {
+        if (sat.model_value(white[id]) || part[id] >= 0) continue;
+        int p = static_cast<int>(parts.size());
+        parts.emplace_back(1, id);
+        part[id] = p;
+        for (std::size_t head = 0; head < parts[p].size(); ++head) {
+            int cur = parts[p][head];
+            for (int delta : dir) {
+                int nid = cur + delta;
+                if (white[nid] < 0 || part[nid] >= 0 || sat.model_value(white[nid])) continue;
+                part[nid] = p;
+                parts[p].push_back(nid);
+            }
+        }
+    }
+    if (parts.size() <= 1) return false;
+
+    // Частина з білою межею не може бути всією чорною областю, поки поза нею лишається чорна клітинка outside
+    std::vector<char> border(size, 0);
+    for (std::size_t p = 0; p < parts.size(); ++p) {
+        int outside = parts[p == 0 ? 1 : 0][0];
+        lits_.clear();
+        lits_.push_back(lit(white[outside], true));
+        for (int id : parts[p]) {
+            lits_.push_back(lit(white[id], true));
+            for (int delta : dir) {
+                int nid = id + delta;
+                if (white[nid] < 0 || part[nid] == static_cast<int>(p) || border[nid]) continue;
+                border[nid] = 1;
+                lits_.push_back(lit(white[nid], false));
+            }
+        }
+        for (int id : parts[p])
+            for (int delta : dir) border[id + delta] = 0;
+        sat.add_clause(lits_);
+    }
+    return true;
+}
+
+// Метод для розв'язання задачі через SAT-кодування
+void nurikabe_solver::solve_sat(const grid &initial, const step_callback &on_step) {
+    if (stats_) stats_->reset();
+    stat_timer timer(stats_, &solver_stats::time_total);
+    start_limits();
+    nodes_ = 0;
+    interrupted_ = false;
+
+    // Обмеження перевіряються після кожного конфлікту — він тут замість вузла пошуку
+    sat_solver::stop_check stop;
+    if (limits_active_) {
+        stop = [this] {
+            ++nodes_;
+            return !within_limits();
+        };
+    }
+
+    sat_encoding cnf(initial);
+    bool solved = false;
+    if (cnf.encode(initial)) {
+        while (cnf.sat.solve(stop) == sat_solver::result::SATISFIABLE) {
+            if (!cnf.add_black_cuts()) {
+                solved = true;
+                break;
+            }
+        }
+    }
+    if (stats_) stats_->nodes = cnf.sat.conflicts();
+    throw_if_interrupted();
+    if (!solved) throw std::runtime_error("Рішення не існує");
+
+    // Острови рішення записуються так само, як їх збирає пошук, тож кроки відновлює recover_step_by_step
+    initial_grid_ = initial;
+    size_ = initial.size();
+    dir_[0] = cnf.dir[0];
+    dir_[1] = cnf.dir[1];
+    dir_[2] = cnf.dir[2];
+    dir_[3] = cnf.dir[3];
+    solution_cells_.clear();
+    solution_ends_.clear();
+    Path region;
+    for (int k = static_cast<int>(cnf.clue_cells.size()); k-- > 0;) {
+        region.assign(1, cnf.clue_cells[k]);
+        for (int id : cnf.cells)
+            if (id != cnf.clue_cells[k] && cnf.own[k][id] >= 0 && cnf.sat.model_value(cnf.own[k][id])) region.push_back(id);
+        push_solution(region);
+    }
+    recover_step_by_step(on_step);
+    release();
+}
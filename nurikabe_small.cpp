@@ -0,0 +1,361 @@
+// nurikabe_small.cpp
+#include "nurikabe_small.hpp"
+#include "nurikabe_solver.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// Метод для заливки по дозволених клітинках
+template <class Mask>
+Mask small_board_solver<Mask>::flood(Mask seed, Mask allowed) const {
+    seed &= allowed;
+    while (true) {
+        Mask next = (seed | neighbours(seed)) & allowed;
+        if (next == seed) return seed;
+        seed = next;
+    }
+}
+
+// Метод для перевірки чорних блоків 2x2: біт вікна встановлений, якщо чорні всі чотири його клітинки
+template <class Mask>
+bool small_board_solver<Mask>::has_black_2x2(Mask black) const {
+    Mask pairs = black & (black >> 1) & not_last_col_;
+    return (pairs & (pairs >> cols_)) != 0;
+}
+
+// Метод для пошуку порожніх клітинок, без яких вікно 2x2 стало б повністю чорним
+template <class Mask>
+Mask small_board_solver<Mask>::escape_cells(Mask black, Mask empty) const {
+    // Кути вікна з лівим верхнім кутом i: i, i + 1, i + cols, i + cols + 1
+    int down = cols_, diagonal = cols_ + 1;
+    Mask b0 = black, b1 = black >> 1, b2 = black >> down, b3 = black >> diagonal;
+    Mask e0 = empty, e1 = empty >> 1, e2 = empty >> down, e3 = empty >> diagonal;
+    Mask result = (window_ & e0 & b1 & b2 & b3) |
+                  ((window_ & b0 & e1 & b2 & b3) << 1) |
+                  ((window_ & b0 & b1 & e2 & b3) << down) |
+                  ((window_ & b0 & b1 & b2 & e3) << diagonal);
+    return result & all_;
+}
+
+// Метод для побудови карти досяжності числа: заливка на відстань значення - 1
+template <class Mask>
+Mask small_board_solver<Mask>::reach(const state &s, int k) const {
+    Mask allowed = clue_base_[k] & ~s.black & ~s.island;
+    Mask result = Mask(1) << clue_cell_[k];
+    for (int step = 1; step < clue_value_[k]; ++step) {
+        Mask next = result | (neighbours(result) & allowed);
+        if (next == result) break;
+        result = next;
+    }
+    return result;
+}
+
+// Метод для застосування висновків, поки вони щось змінюють
+template <class Mask>
+bool small_board_solver<Mask>::propagate(state &s) const {
+    while (true) {
+        bool changed = false;
+
+        // Клітинки, недосяжні для жодного невикористаного числа, — чорні; біла недосяжна — суперечність
+        Mask cover = 0;
+        for (int k = 0; k < static_cast<int>(clue_cell_.size()); ++k)
+            if (!(s.used >> k & 1)) cover |= reach(s, k);
+        if (s.white & ~cover) return false;
+        Mask empty = all_ & ~(s.black | s.island | s.white | clues_);
+        if (Mask dead = empty & ~cover) {
+            s.black |= dead;
+            empty &= ~dead;
+            changed = true;
+        }
+
+        // Вікно 2x2 з трьома чорними: четверта клітинка біла
+        if (has_black_2x2(s.black)) return false;
+        if (Mask escape = escape_cells(s.black, empty)) {
+            s.white |= escape;
+            empty &= ~escape;
+            changed = true;
+        }
+
+        // Усі чорні — в одній частині чорних і порожніх клітинок, частини без чорних білі
+        if (s.black) {
+            Mask open = s.black | empty;
+            Mask part = flood(s.black & (~s.black + 1), open);
+            if (s.black & ~part) return false;
+            if (Mask pockets = open & ~part) {
+                s.white |= pockets;
+                changed = true;
+            }
+        }
+
+        if (!changed) return true;
+    }
+}
+
+// Метод для перебору областей числа k
+template <class Mask>
+int small_board_solver<Mask>::enumerate(const state &s, int k, int limit, std::vector<Mask> *out) {
+    Mask start = Mask(1) << clue_cell_[k];
+    allowed_ = reach(s, k) & ~start;
+    white_ = s.white;
+    target_ = clue_value_[k];
+    count_ = 0;
+    limit_ = limit;
+    out_ = out;
+
+    if (target_ == 1) {
+        if (!(neighbours(start) & white_)) {
+            ++count_;
+            if (out_) out_->push_back(start);
+        }
+        return count_;
+    }
+
+    untried_.clear();
+    Mask fresh = neighbours(start) & allowed_;
+    reached_ = start | fresh;
+    for (; fresh; fresh &= fresh - 1) untried_.push_back(fresh & (~fresh + 1));
+    grow(start, 1, 0);
+    return count_;
+}
+
+// Метод для рекурсивного розширення області клітинками з untried_[from..)
+template <class Mask>
+void small_board_solver<Mask>::grow(Mask region, int size, int from) {
+    // Той самий порядок, що й у nurikabe_solver::grow_region: нові сусіди дописуються в кінець untried_
+    int to = static_cast<int>(untried_.size());
+    for (int i = from; i < to && count_ < limit_; ++i) {
+        Mask next = region | untried_[i];
+        if (size + 1 == target_) {
+            // Біла клітинка поруч з областю мусить належати їй
+            if (!(neighbours(next) & white_ & ~next)) {
+                ++count_;
+                if (out_) out_->push_back(next);
+            }
+            continue;
+        }
+
+        Mask fresh = neighbours(untried_[i]) & allowed_ & ~reached_;
+        reached_ |= fresh;
+        for (Mask rest = fresh; rest; rest &= rest - 1) untried_.push_back(rest & (~rest + 1));
+        grow(next, size + 1, i + 1);
+        reached_ &= ~fresh;
+        untried_.resize(to);
+    }
+}
+
+// Метод для рекурсивного пошуку
+template <class Mask>
+bool small_board_solver<Mask>::search(state s, int depth) {
+    if (*stop_ && (*stop_)()) {
+        interrupted_ = gave_up_ = true;
+        return false;
+    }
+    if (++nodes_ > budget_) {
+        gave_up_ = true;
+        return false;
+    }
+    if (!propagate(s)) return false;
+
+    // Усі числа використані: решта порожніх чорні, білих без острова не лишилося, чорна область ціла
+    int clue_count = static_cast<int>(clue_cell_.size());
+    if (s.used == all_used_) {
+        if (s.white) return false;
+        Mask black = all_ & ~(s.island | clues_);
+        if (has_black_2x2(black)) return false;
+        return !black || flood(black & (~black + 1), black) == black;
+    }
+
+    // Число з найменшою кількістю областей (рахуємо, як і nurikabe_solver, до BRANCH_COUNT_LIMIT), при рівності — з меншим значенням
+    int best = -1, best_count = nurikabe_solver::BRANCH_COUNT_LIMIT + 1;
+    for (int k = 0; k < clue_count; ++k) {
+        if (s.used >> k & 1) continue;
+        int count = enumerate(s, k, std::min(best_count + 1, nurikabe_solver::BRANCH_COUNT_LIMIT), nullptr);
+        if (count == 0) return false;
+        if (count < best_count || (count == best_count && clue_value_[k] < clue_value_[best])) {
+            best = k;
+            best_count = count;
+            if (count == 1) break;
+        }
+    }
+
+    // Області зберігаються списком, тож числа з надто великою кількістю варіантів лишаємо загальному розв'язувачу
+    if (best_count >= nurikabe_solver::BRANCH_COUNT_LIMIT) {
+        gave_up_ = true;
+        return false;
+    }
+
+    std::vector<Mask> &regions = pool_[depth];
+    regions.clear();
+    enumerate(s, best, std::numeric_limits<int>::max(), &regions);
+    for (Mask cells : regions) {
+        // Область фіксується разом з чорною межею; стан дитини — копія
+        state next = s;
+        next.island |= cells;
+        next.white &= ~cells;
+        next.black |= neighbours(cells) & ~cells;
+        next.used |= std::uint64_t(1) << best;
+        if (has_black_2x2(next.black)) continue;
+
+        solution_.push_back({ clue_cell_[best], cells });
+        if (search(next, depth + 1)) return true;
+        solution_.pop_back();
+        if (gave_up_) return false;
+    }
+    return false;
+}
+
+// Метод для розв'язання задачі
+template <class Mask>
+typename small_board_solver<Mask>::outcome small_board_solver<Mask>::solve(const flat_grid &puzzle, long long node_budget, const stop_check &stop) {
+    rows_ = puzzle.rows();
+    cols_ = puzzle.cols();
+    solution_.clear();
+    nodes_ = 0;
+    budget_ = node_budget;
+    gave_up_ = false;
+    interrupted_ = false;
+    stop_ = &stop;
+    if (!fits(rows_, cols_)) return outcome::GAVE_UP;
+
+    // Маски сітки
+    int cells = rows_ * cols_;
+    all_ = cells == MAX_CELLS ? ~Mask(0) : (Mask(1) << cells) - 1;
+    not_first_col_ = not_last_col_ = 0;
+    for (int i = 0; i < cells; ++i) {
+        if (i % cols_ != 0) not_first_col_ |= Mask(1) << i;
+        if (i % cols_ != cols_ - 1) not_last_col_ |= Mask(1) << i;
+    }
+    window_ = not_last_col_ & (all_ >> cols_);
+
+    // Числа; сусідні числа завжди в одному острові, як і в nurikabe_solver::prepare
+    clue_cell_.clear();
+    clue_value_.clear();
+    clues_ = 0;
+    for (int r = 0; r < rows_; ++r) {
+        for (int c = 0; c < cols_; ++c) {
+            int v = puzzle.at(r, c);
+            if (v < 0) return outcome::GAVE_UP;
+            if (v == 0) continue;
+            if ((r + 1 < rows_ && puzzle.at(r + 1, c) > 0) || (c + 1 < cols_ && puzzle.at(r, c + 1) > 0))
+                return outcome::NO_SOLUTION;
+            clue_cell_.push_back(r * cols_ + c);
+            clue_value_.push_back(v);
+            clues_ |= Mask(1) << (r * cols_ + c);
+        }
+    }
+    // Без сусідніх чисел їх не більше половини клітинок, тож 64 біти used вистачає; перевіряємо про всяк випадок
+    int clue_count = static_cast<int>(clue_cell_.size());
+    if (clue_count > 64) return outcome::GAVE_UP;
+    all_used_ = clue_count == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << clue_count) - 1;
+
+    clue_base_.assign(clue_count, 0);
+    for (int k = 0; k < clue_count; ++k) {
+        Mask own = Mask(1) << clue_cell_[k];
+        clue_base_[k] = all_ & ~clues_ & ~neighbours(clues_ & ~own);
+    }
+
+    pool_.resize(clue_count + 1);
+    untried_.reserve(cells);
+
+    // Початкові чорні клітинки задачі не задаються, тож стан кореня — лише числа
+    state root{ 0, 0, 0, 0 };
+    if (search(root, 0)) return outcome::SOLVED;
+    solution_.clear();
+    if (interrupted_) return outcome::INTERRUPTED;
+    return gave_up_ ? outcome::GAVE_UP : outcome::NO_SOLUTION;
+}
+
+template class small_board_solver<std::uint64_t>;
+#ifdef __SIZEOF_INT128__
+template class small_board_solver<unsigned __int128>;
+#endif
+
+// Передає кроки рішення малого розв'язувача так само, як nurikabe_solver::recover_step_by_step
+template <class Mask>
+static void emit_small_steps(const flat_grid &initial, const small_board_solver<Mask> &engine,
+                             const nurikabe_solver::step_callback &on_step) {
+    flat_grid current = initial;
+    int cols = initial.cols(), stride = initial.stride();
+    const int dir[4] = { -stride, stride, -1, 1 };
+
+    nurikabe_solver::solve_step step;
+    step.total = static_cast<int>(engine.regions().size()) + 1;
+    auto change = [&](int id, int value) {
+        current[id] = value;
+        step.changes.push_back({ current.row_of(id), current.col_of(id), value });
+    };
+
+    std::vector<int> ids;
+    for (const auto &region : engine.regions()) {
+        step.changes.clear();
+        ids.clear();
+        for (int bit = 0; bit < initial.rows() * cols; ++bit)
+            if (region.cells >> bit & 1) ids.push_back(initial.index(bit / cols, bit % cols));
+
+        for (int id : ids) {
+            if (current[id] == nurikabe_solver::EMPTY) change(id, nurikabe_solver::FILLED);
+        }
+        for (int id : ids) {
+            for (int d = 0; d < 4; ++d) {
+                int nid = id + dir[d];
+                if (current[nid] == nurikabe_solver::EMPTY) change(nid, nurikabe_solver::BLACK);
+            }
+        }
+        ++step.number;
+        on_step(step);
+    }
+
+    step.changes.clear();
+    for (int id = 0; id < current.size(); ++id) {
+        if (current[id] == nurikabe_solver::EMPTY) change(id, nurikabe_solver::BLACK);
+    }
+    ++step.number;
+    on_step(step);
+}
+
+// Запуск малого розв'язувача: false — задача виявилась для нього заважкою або пошук перервано
+template <class Mask>
+static bool run_small(const flat_grid &initial, long long budget, const nurikabe_solver::step_callback &on_step,
+                      const typename small_board_solver<Mask>::stop_check &stop) {
+    // Розв'язувач тримає лише буфери, тож один на потік перевикористовується між задачами
+    thread_local small_board_solver<Mask> engine;
+    switch (engine.solve(initial, budget, stop)) {
+        case small_board_solver<Mask>::outcome::SOLVED:
+            emit_small_steps(initial, engine, on_step);
+            return true;
+        case small_board_solver<Mask>::outcome::NO_SOLUTION:
+            throw std::runtime_error("Рішення не існує");
+        default:
+            return false;
+    }
+}
+
+// Метод для вибору найменшого розв'язувача, в слово якого вміщується сітка
+bool nurikabe_solver::solve_small(const grid &initial, const step_callback &on_step) {
+    // Статистика описує пошук загального розв'язувача
+    if (!small_engine_ || stats_) return false;
+
+    // Обмеження вже зафіксовані викликачем (start_limits) і перевіряються в кожному вузлі малого пошуку
+    nodes_ = 0;
+    interrupted_ = false;
+    std::function<bool()> stop;
+    if (limits_active_) {
+        stop = [this] {
+            ++nodes_;
+            return !within_limits();
+        };
+    }
+    long long budget = SMALL_NODE_BUDGET;
+    if (node_limit_ > 0) budget = std::min(budget, node_limit_);
+
+    bool solved = false;
+    if (small_board_solver<std::uint64_t>::fits(initial.rows(), initial.cols()))
+        solved = run_small<std::uint64_t>(initial, budget, on_step, stop);
+#ifdef __SIZEOF_INT128__
+    else if (small_board_solver<unsigned __int128>::fits(initial.rows(), initial.cols()))
+        solved = run_small<unsigned __int128>(initial, budget, on_step, stop);
+#endif
+    // Перерваний малий пошук нічого не доводить, а загальний одразу вперся б у ті самі обмеження
+    throw_if_interrupted();
+    return solved;
+}
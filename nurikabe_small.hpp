@@ -0,0 +1,124 @@
+// nurikabe_small.hpp
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "flat_grid.hpp"
+
+/*
+    Розв'язувач малих задач, уся сітка яких уміщується в одне машинне слово Mask
+    (std::uint64_t — до 64 клітинок, unsigned __int128 — до 128). Клітинка (r, c) — біт r * cols + c.
+    Стан вузла пошуку — кілька масок, тож замість журналу змін він просто копіюється в рекурсію,
+    а сусіди, заливки й вікна 2x2 рахуються зсувами всієї сітки одразу.
+
+    Пошук той самий, що й у nurikabe_solver: розгалуження на числі з найменшою кількістю областей (MRV),
+    область з чорною межею, висновки (недосяжні клітинки чорні, вікно 2x2 з трьома чорними має білу клітинку,
+    кишені без чорних білі) і перевірки блоків 2x2 та зв'язності. Визначення — у nurikabe_small.cpp
+    з явними екземплярами для обох розмірів слова
+*/
+template <class Mask>
+class small_board_solver {
+public:
+    // Найбільша кількість клітинок сітки
+    static constexpr int MAX_CELLS = static_cast<int>(sizeof(Mask) * 8);
+
+    enum class outcome {
+        SOLVED,        // рішення знайдено (regions)
+        NO_SOLUTION,   // пошук перебрав усе — рішення немає
+        GAVE_UP,       // вичерпано ліміт вузлів або задача не підходить — треба загальний розв'язувач
+        INTERRUPTED    // пошук перервала перевірка stop
+    };
+
+    // Перевірка, чи треба перервати пошук (обмеження часу, вузлів, скасування); викликається в кожному вузлі
+    using stop_check = std::function<bool()>;
+
+    // Область рішення: клітинка з числом і маска клітинок області
+    struct region {
+        int clue;
+        Mask cells;
+    };
+
+    // Чи вміщується сітка rows × cols (зсув на cols + 1 має лишатися в межах слова)
+    static bool fits(int rows, int cols) {
+        return rows > 0 && cols > 0 && rows * cols <= MAX_CELLS && cols + 1 < MAX_CELLS;
+    }
+
+    // Розв'язує задачу, перебравши не більше node_budget вузлів; stop може бути порожнім
+    outcome solve(const flat_grid &puzzle, long long node_budget, const stop_check &stop = stop_check());
+
+    // Області рішення в порядку від кореня пошуку
+    const std::vector<region> &regions() const { return solution_; }
+
+    // Кількість вузлів останнього пошуку
+    long long nodes() const { return nodes_; }
+
+private:
+    // Стан вузла пошуку
+    struct state {
+        Mask black;           // чорні клітинки
+        Mask island;          // клітинки зафіксованих островів разом з їхніми числами
+        Mask white;           // клітинки, що точно білі, але ще не належать жодному острову
+        std::uint64_t used;   // зафіксовані числа (біт k — число k)
+    };
+
+    int rows_ = 0;
+    int cols_ = 0;
+    Mask all_ = 0;            // усі клітинки сітки
+    Mask not_first_col_ = 0;  // клітинки, що мають сусіда ліворуч
+    Mask not_last_col_ = 0;   // клітинки, що мають сусіда праворуч
+    Mask window_ = 0;         // лівий верхній кут кожного вікна 2x2
+    Mask clues_ = 0;          // клітинки з числами
+
+    std::vector<int> clue_cell_;     // клітинка числа k (номер біта)
+    std::vector<int> clue_value_;    // значення числа k
+    std::vector<Mask> clue_base_;    // клітинки, які число k може взяти в принципі: не числа й не сусіди інших чисел
+    std::uint64_t all_used_ = 0;     // used, коли зафіксовані всі числа
+
+    long long nodes_ = 0;
+    long long budget_ = 0;
+    bool gave_up_ = false;
+    bool interrupted_ = false;
+    const stop_check *stop_ = nullptr;
+    std::vector<std::vector<Mask>> pool_;  // буфери областей для кожної глибини пошуку
+    std::vector<region> solution_;
+
+    // Робочий стан перебору областей
+    std::vector<Mask> untried_;      // клітинки (по одному біту), які ще можна додати до області
+    Mask reached_ = 0;               // клітинки, що вже потрапляли в untried_ на цій гілці перебору
+    Mask allowed_ = 0;               // клітинки, доступні області
+    Mask white_ = 0;                 // білі клітинки, які область не може лишити поруч
+    int target_ = 0;                 // розмір області
+    int count_ = 0;                  // знайдено областей
+    int limit_ = 0;                  // після скількох областей перебір зупиняється
+    std::vector<Mask> *out_ = nullptr;
+
+    // Сусіди всіх клітинок маски
+    Mask neighbours(Mask m) const {
+        return ((m & not_first_col_) >> 1) | ((m & not_last_col_) << 1) | (m >> cols_) | ((m << cols_) & all_);
+    }
+
+    // Заливка від seed по клітинках allowed
+    Mask flood(Mask seed, Mask allowed) const;
+
+    // Чи є повністю чорне вікно 2x2
+    bool has_black_2x2(Mask black) const;
+
+    // Порожні клітинки вікон 2x2 з трьома чорними
+    Mask escape_cells(Mask black, Mask empty) const;
+
+    // Клітинки, досяжні областю числа k у стані s (разом з самим числом)
+    Mask reach(const state &s, int k) const;
+
+    // Висновки до нерухомої точки; false — суперечність
+    bool propagate(state &s) const;
+
+    // Перебирає області числа k, рахуючи їх до limit і зберігаючи в out, якщо він не nullptr
+    int enumerate(const state &s, int k, int limit, std::vector<Mask> *out);
+
+    // Рекурсивне розширення області (перебір Редельмаєра, як у nurikabe_solver::grow_region)
+    void grow(Mask region, int size, int from);
+
+    // Рекурсивний пошук
+    bool search(state s, int depth);
+};
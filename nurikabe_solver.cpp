@@ -1,49 +1,214 @@
 // nurikabe_solver.cpp
 #include "nurikabe_solver.hpp"
-#include <unordered_set>
 #include <queue>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <iomanip>
 #include <stdexcept>
 
+// Повідомлення для причини переривання пошуку
+static const char *interrupt_message(solve_interrupted::reason why) {
+    switch (why) {
+        case solve_interrupted::reason::TIME_LIMIT: return "Перевищено обмеження часу розв'язання";
+        case solve_interrupted::reason::NODE_LIMIT: return "Перевищено обмеження кількості вузлів пошуку";
+        default: return "Розв'язання скасовано";
+    }
+}
+
+solve_interrupted::solve_interrupted(reason why) : std::runtime_error(interrupt_message(why)), why_(why) {}
+
 // Рекурсивний алгоритм пошуку
 std::vector<nurikabe_solver::grid> nurikabe_solver::solve(const grid initial) {
-    // Зберігаємо незмінну копію та ініціалізуємо робочу сітку
-    initial_grid_ = initial;
-    rows_ = static_cast<int>(initial.size());
-    cols_ = rows_ ? static_cast<int>(initial[0].size()) : 0;
-    grid_ = initial;
-    used_.assign(rows_ * cols_, 0);
+    // Повні сітки всіх кроків будуємо з потоку змін
+    std::vector<grid> res;
+    grid current = initial;
+    solve(initial, [&](const solve_step &step) {
+        apply_step(current, step);
+        res.push_back(current);
+    });
 
-    // Рекурсивний пошук
-    if (!solve_recurse()) {
+    // Повертаємо покрокове відновлення
+    return res;
+}
+
+// Рекурсивний алгоритм пошуку з передачею кроків обробнику
+void nurikabe_solver::solve(const grid initial, const step_callback &on_step) {
+    if (engine_ == engine::SAT) {
+        solve_sat(initial, on_step);
+        return;
+    }
+
+    // Обмеження діють з самого початку, зокрема й на малий розв'язувач
+    start_limits();
+
+    // Мала сітка вміщується в одне машинне слово — спершу пробуємо розв'язувач на бітових масках
+    if (solve_small(initial, on_step)) return;
+
+    if (stats_) stats_->reset();
+    stat_timer timer(stats_, &solver_stats::time_total);
+
+    if (!prepare(initial) || !solve_recurse()) {
         // Повертаємо початковий стан глобальних полів
-        grid_.clear();
-        used_.clear();
-        rows_ = 0;
-        cols_ = 0;
-        initial_grid_.clear();
+        release();
+        // Перерваний пошук нічого не доводить, тож "рішення не існує" повідомляємо лише після повного перебору
+        throw_if_interrupted();
         throw std::runtime_error("Рішення не існує");
     }
 
-    grid_.clear();
-    used_.clear();
-
     // Відновлюємо покроково рішення
-    std::vector<nurikabe_solver::grid> res = recover_step_by_step();
+    recover_step_by_step(on_step);
     // Повертаємо початковий стан глобальних полів
+    release();
+}
+
+// Метод для підрахунку рішень з ранньою зупинкою
+int nurikabe_solver::count_solutions(const grid initial, int limit) {
+    return count_solutions(initial, limit, solution_callback());
+}
+
+// Метод для підрахунку рішень з передачею кожного знайденого рішення обробнику
+int nurikabe_solver::count_solutions(const grid initial, int limit, const solution_callback &on_solution) {
+    if (limit <= 0) throw std::runtime_error("Межа кількості рішень має бути додатною");
+    if (stats_) stats_->reset();
+    stat_timer timer(stats_, &solver_stats::time_total);
+
+    // solve_recurse рахує кожне рішення в solutions_ і повертає true, лише коли їх набралося count_limit_
+    count_limit_ = limit;
+    solutions_ = 0;
+    on_solution_ = on_solution ? &on_solution : nullptr;
+    start_limits();
+    if (prepare(initial)) solve_recurse();
+    int found = solutions_;
+    count_limit_ = 0;
+    on_solution_ = nullptr;
+    release();
+    // Перерваний підрахунок не дає відповіді: знайдених рішень може бути менше, ніж є насправді
+    throw_if_interrupted();
+    return found;
+}
+
+// Метод для фіксації обмежень на початку розв'язання
+void nurikabe_solver::start_limits() {
+    limits_active_ = time_limit_ > 0 || node_limit_ > 0 || cancel_;
+    if (time_limit_ > 0) {
+        deadline_ = std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_limit_));
+    }
+}
+
+// Метод для повідомлення про перерваний пошук
+void nurikabe_solver::throw_if_interrupted() const {
+    if (interrupted_) throw solve_interrupted(interrupt_reason_);
+}
+
+// Метод для застосування кроку рішення до сітки
+void nurikabe_solver::apply_step(grid &g, const solve_step &step) {
+    for (const cell_change &change : step.changes)
+        g.at(change.row, change.col) = change.value;
+}
+
+// Метод для ініціалізації робочого стану і логічних висновків до початку перебору
+bool nurikabe_solver::prepare(const grid &initial) {
+    // Зберігаємо незмінну копію та ініціалізуємо робочу сітку
+    initial_grid_ = initial;
+    rows_ = initial.rows();
+    cols_ = initial.cols();
+    size_ = initial.size();
+    grid_ = initial;
+
+    // Сусіди клітинки в плоскому масиві: вверх, вниз, вліво, вправо
+    dir_[0] = -initial.stride();
+    dir_[1] = initial.stride();
+    dir_[2] = -1;
+    dir_[3] = 1;
+
+    used_.assign(size_, 0);
+    reached_.assign(size_, 0);
+    in_path_.assign(size_, 0);
+    untried_.clear();
+    untried_.reserve(size_);
+    target_mark_.assign(size_, 0);
+    visit_mark_.assign(size_, 0);
+    stamp_ = 0;
+    bfs_queue_.resize(size_);
+
+    // Кожна клітинка змінюється на одній гілці пошуку не більше двох разів (фарбування і фінальне заповнення)
+    trail_.clear();
+    trail_.reserve(2 * size_);
+
+    // Будуємо бітове представлення робочої сітки
+    board_.reset(rows_, cols_);
+    for (int r = 0; r < rows_; ++r)
+        for (int c = 0; c < cols_; ++c)
+            board_.set(r, c, grid_.at(r, c));
+
+    // Рахуємо чорні клітинки у вікнах 2x2, далі лічильники підтримує set_cell
+    window_black_.assign(size_, 0);
+    full_windows_ = 0;
+    for (int id = 0; id < size_; ++id)
+        if (grid_[id] == BLACK) count_black_windows(id, 1);
+
+    decisions_.clear();
+    solution_cells_.clear();
+    solution_ends_.clear();
+
+    nodes_ = 0;
+    interrupted_ = false;
+
+    // Сусідні числа завжди опиняються в одному острові, тож таку задачу розв'язати не можна
+    for (int id = 0; id < size_; ++id)
+        if (grid_[id] > 0 && (grid_[id + dir_[1]] > 0 || grid_[id + dir_[3]] > 0)) return false;
+
+    /*
+        Повну перевірку зв'язності робимо лише раз. Далі чорні та порожні клітинки можуть тільки зникати
+        (ставати заповненими або білими), тож кожен вузол пошуку перевіряє лише околицю змінених клітинок.
+        Відокремлені порожні кишені без чорних клітинок не є помилкою — вони стають білими.
+        Після цього логічні висновки до початку перебору
+    */
+    candidates_ready_ = false;
+    build_reach_maps();
+    if (stats_) {
+        // Статистика чисел у тому ж порядку, що й карти досяжності
+        stats_->clues.assign(slot_clue_.size(), solver_stats::clue_stat());
+        for (size_t slot = 0; slot < slot_clue_.size(); ++slot) {
+            int id = slot_clue_[slot];
+            solver_stats::clue_stat &clue = stats_->clues[slot];
+            clue.row = initial.row_of(id);
+            clue.col = initial.col_of(id);
+            clue.value = grid_[id];
+        }
+    }
+    if (!(is_black_area_connected() || resolve_open_pockets()) || !propagate()) return false;
+
+    // Варіанти областей будуємо вже для стану після висновків — так їх менше
+    build_candidates();
+    return true;
+}
+
+// Метод для скидання глобальних полів після розв'язання
+void nurikabe_solver::release() {
+    reach_ready_ = false;
+    reach_dist_.clear();
+    reach_cells_.clear();
+    candidates_ready_ = false;
+    candidates_.clear();
+    cand_cells_.clear();
+    member_list_.clear();
+    halo_list_.clear();
+    listed_clues_.clear();
+    grid_ = grid();
+    used_.clear();
     rows_ = 0;
     cols_ = 0;
-    initial_grid_.clear();
-
-    // Повертаємо покрокове відновлення
-    return res;
+    size_ = 0;
+    initial_grid_ = grid();
 }
 
 bool nurikabe_solver::solve_recurse() {
     // Список для зберігання вільних клітинок з числами
-    std::vector<cell> nums;
+    std::vector<int> nums;
     collect_numbers(nums);
 
     if (nums.empty()) {
@@ -51,266 +216,468 @@ bool nurikabe_solver::solve_recurse() {
             Якщо вільних клітинок не залишилося - заповнюємо можливі пропуски в сітці і перевіряємо чи є чорні блоки 2x2,
             якщо ні - рішення знайдено і повертаємо true, якщо так - відновлюєм пропуски і повертаємо false
         */
-        std::vector<cell> spaces;
-        fill_spaces(spaces);
-        if (!has_black_2x2_block()) return true;
-        for (auto &cc : spaces) grid_[cc.row][cc.col] = EMPTY;
-        return false;
+        size_t mark = trail_.size();
+        fill_spaces();
+        bool solved = false;
+        if (!has_full_black_window()) {
+            stat_timer timer(stats_, &solver_stats::time_connectivity);
+            solved = is_black_area_connected();
+        }
+        if (solved && !count_limit_) return true;
+        if (solved && on_solution_) (*on_solution_)(grid_);
+        undo_to(mark);
+        if (!solved) return prune(&solver_stats::failed_leaves);
+
+        /*
+            Режим підрахунку: рішення зараховано, пошук іде далі, поки їх не набереться count_limit_.
+            Розгалуження на одному числі ділить рішення між гілками без перетинів, тож жодне не рахується двічі
+        */
+        return ++solutions_ >= count_limit_;
+    }
+
+    ++nodes_;
+
+    // Обмеження часу, вузлів і скасування; без них — одна перевірка прапорця
+    if (limits_active_ && !within_limits()) return false;
+
+    if (stats_) {
+        ++stats_->nodes;
+        stats_->max_depth = std::max(stats_->max_depth, static_cast<int>(decisions_.size()));
     }
 
     /*
-        Сортуємо числа за зростанням, щоб обробляти області з меншою кількістю клітинок в першу чергу —
-        це дозволяє раніше виключати помилкові гілки
+        Розгалужуємося на числі з найменшою кількістю варіантів області; якщо якесь число їх не має — гілка неправильна.
+        Таблиця спростованих станів тут нічого б не дала: гілки вузла відрізняються областю одного числа,
+        а клітинки цієї області вже не змінюються в піддереві, тож той самий стан двічі в дереві пошуку не трапляється
     */
-    std::sort(nums.begin(), nums.end(), [&](cell const& a, cell const& b) {
-        return grid_[a.row][a.col] < grid_[b.row][b.col];
-    });
+    int center;
+    {
+        stat_timer timer(stats_, &solver_stats::time_select);
+        center = select_branch_clue(nums);
+    }
+    if (center < 0) return prune(&solver_stats::prune_no_candidates);
 
-    // Перебираємо кожну числову клітинку і намагаємося збудувати область потрібного розміру
-    for (cell center : nums) {
-        int total = grid_[center.row][center.col];
-        // Знаходимо всі допустимі способи розширити область з однієї клітинки
-        auto paths = find_all_valid_paths(center, total);
-        for (auto &path : paths) {
-            // Позначаємо поточний шлях як "FILLED", тобто уже сформовану область
-            for (int idx = 0; idx < rows_*cols_; ++idx) {
-                if (path[idx] && idx != center.row*cols_ + center.col)
-                    grid_[idx / cols_][idx % cols_] = FILLED;
-            }
-            /* 
-                Позначаємо всі сусідні клітинки області в чорний, попередньо записуючи їх у список для майбутнього можливого відновлення,
-                якщо шлях некоректний
-            */
-            std::vector<char> painted(rows_*cols_, 0);
-            paint_adjacent(path, painted);
-
-            // Позначаємо клітинку як "використану"
-            used_[center.row * cols_ + center.col] = 1;
-
-            /*
-                Перевірка чи має поточна область чорні блоки 2 на 2 та чи чорна область зв'язна,
-                якщо - так викликаємо рекурсивно метод solve, якщо він повертає true - передаємо цей результат далі по стеку
-            */
-            if (!has_black_2x2_block() && is_black_area_connected() && solve_recurse()) {
-                path_stack_.push(path);
-                return true;
-            }
+    // Знаходимо всі допустимі способи розширити область з однієї клітинки
+    std::vector<Path> paths;
+    {
+        stat_timer timer(stats_, &solver_stats::time_enumerate);
+        paths = candidate_paths(center);
+    }
+    if (stats_) {
+        stats_->regions += paths.size();
+        stats_->clues[clue_slot_[center]].regions += paths.size();
+    }
+    for (size_t i = 0; i < paths.size(); ++i) {
+        // Пошук перервано обмеженням — решту областей не перебираємо
+        if (interrupted_) return false;
+        // У паралельному режимі віддаємо ще не спробувані області вільним потокам або зупиняємось, якщо рішення вже знайдено
+        if (shared_ && !poll_parallel(paths, i + 1)) return false;
 
-            // Шлях був неправильний, повертаємо клітинку назад
-            used_[center.row * cols_ + center.col] = 0;
-            // Шлях був неправильний, прибираємо позначення області як заповненої і перефарбовуємо сусідів в пусті клітинки
-            for (int idx = 0; idx < rows_*cols_; ++idx) {
-                if (path[idx] && idx != center.row*cols_ + center.col)
-                    grid_[idx / cols_][idx % cols_] = EMPTY;
-                if (painted[idx])
-                    grid_[idx / cols_][idx % cols_] = EMPTY;
-            }
+        const Path &path = paths[i];
+        // Запам'ятовуємо позицію журналу змін, до якої відкотимося, якщо шлях неправильний
+        size_t mark = trail_.size();
+
+        /*
+            Перевірка чи має поточна область чорні блоки 2 на 2 та чи чорна область зв'язна, далі логічні висновки з нового стану,
+            якщо все гаразд - викликаємо рекурсивно метод solve, якщо він повертає true - передаємо цей результат далі по стеку
+        */
+        bool ok = apply_region(path);
+        if (ok) {
+            decisions_.push_back(&path);
+            ok = solve_recurse();
+            decisions_.pop_back();
         }
+        if (ok) {
+            push_solution(path);
+            return true;
+        }
+
+        // Шлях був неправильний, повертаємо клітинку назад
+        set_used(center, 0);
+        // Шлях був неправильний, відкочуємо лише ті клітинки, які він змінив (область і пофарбованих сусідів)
+        undo_to(mark);
+    }
+
+    // Якщо для вибраного числа жоден варіант області не підійшов — гілка неправильна
+    return false;
+}
+
+// Метод для фіксації області числа path[0]: клітинки області, чорна межа і логічні висновки
+bool nurikabe_solver::apply_region(const Path &path) {
+    int center = path.front();
 
-        // Якщо для поточного числа не знайдено жодного допустимого варіанту області — гілка неправильна
-        return false;
+    // Позначаємо поточний шлях як "FILLED", тобто уже сформовану область
+    for (int idx : path) {
+        if (idx != center)
+            set_cell(idx, FILLED);
     }
+    // Позначаємо всі сусідні клітинки області в чорний, кожна зміна потрапляє в журнал trail_
+    paint_adjacent(path);
 
-    // Якщо не вдалося заповнити хоча б одну область — повертаємо false
+    // Позначаємо клітинку як "використану"
+    set_used(center, 1);
+
+    // Перевірки від найдешевшої; статистика розрізняє, яка з них закрила гілку
+    if (has_full_black_window()) return prune(&solver_stats::prune_2x2);
+    {
+        stat_timer timer(stats_, &solver_stats::time_connectivity);
+        if (!is_black_area_still_connected(path)) return prune(&solver_stats::prune_connectivity);
+    }
+    {
+        stat_timer timer(stats_, &solver_stats::time_propagate);
+        if (!propagate()) return prune(&solver_stats::prune_propagation);
+    }
+    if (has_dead_clue()) return prune(&solver_stats::prune_no_candidates);
+    return true;
+}
+
+// Метод для підрахунку відсіченої гілки
+bool nurikabe_solver::prune(long long solver_stats::*cause) {
+    if (stats_) ++(stats_->*cause);
     return false;
 }
 
-std::vector<nurikabe_solver::grid> nurikabe_solver::recover_step_by_step() {
-    std::vector<grid> steps;
-    grid current = initial_grid_;
+// Метод для вибору числа, на якому розгалужується пошук
+int nurikabe_solver::select_branch_clue(const std::vector<int> &nums) {
+    /*
+        Для чисел зі списками варіантів кількість відома одразу. Решту рахуємо лише до поточного найкращого
+        результату + 1: більше значення вже не виграє, а рівне потрібне тільки для порівняння за кількістю сусідів. Число з нулем областей одразу закриває гілку,
+        число з однією областю — вимушений хід, кращого вибору не буде
+    */
+    int best = -1, best_count = BRANCH_COUNT_LIMIT + 1, best_degree = -1;
+    for (int id : nums) {
+        int count = candidate_count(id, std::min(best_count + 1, BRANCH_COUNT_LIMIT));
+        if (count == 0) return -1;
+        if (count > best_count) continue;
+
+        int degree = clue_degree(id, nums);
+        bool better = count < best_count || degree > best_degree ||
+                      (degree == best_degree && grid_[id] < grid_[best]);
+        if (!better) continue;
+
+        best = id;
+        best_count = count;
+        best_degree = degree;
+        if (best_count == 1) break;
+    }
+    return best;
+}
+
+// Метод для підрахунку чисел, з якими область числа id може взаємодіяти
+int nurikabe_solver::clue_degree(int id, const std::vector<int> &nums) const {
+    /*
+        Області чисел a і b розміру ka і kb можуть торкнутися лише тоді, коли манхеттенська відстань
+        між числами не більша за ka + kb - 1 — тоді їхні варіанти обмежують один одного
+    */
+    int r = grid_.row_of(id), c = grid_.col_of(id);
+    int degree = 0;
+    for (int other : nums) {
+        if (other == id) continue;
+        int dist = std::abs(grid_.row_of(other) - r) + std::abs(grid_.col_of(other) - c);
+        if (dist <= grid_[id] + grid_[other] - 1) ++degree;
+    }
+    return degree;
+}
+
+void nurikabe_solver::recover_step_by_step(const step_callback &on_step) {
+    // Початкова сітка більше не потрібна, тож кроки накладаються прямо на неї
+    grid &current = initial_grid_;
+    solve_step step;
+    step.total = static_cast<int>(solution_ends_.size()) + 1;
+    auto change = [&](int id, int value) {
+        current[id] = value;
+        step.changes.push_back({ current.row_of(id), current.col_of(id), value });
+    };
+
+    // Для кожного шляху, від кореня, послідовно маркуємо клітинки й передаємо зміни
+    for (size_t k = solution_ends_.size(); k-- > 0;) {
+        const int *begin = solution_cells_.data() + (k ? solution_ends_[k - 1] : 0);
+        const int *end = solution_cells_.data() + solution_ends_[k];
+        step.changes.clear();
 
-    // Для кожного шляху послідовно маркуємо клітинки й додаємо новий стан
-    while (!path_stack_.empty()) {
         // Заповнюємо FILLED
-        Path path = path_stack_.top();
-        path_stack_.pop();
-        for (int idx = 0; idx < rows_*cols_; ++idx) {
-            if (path[idx] && current[idx/cols_][idx%cols_] == EMPTY)
-                current[idx/cols_][idx%cols_] = FILLED;
+        for (const int *it = begin; it != end; ++it) {
+            if (current[*it] == EMPTY) change(*it, FILLED);
         }
-        // Фарбуємо чорним
-        for (int idx = 0; idx < rows_*cols_; ++idx) {
-            if (!path[idx]) continue;
-            int r = idx/cols_, c = idx%cols_;
+        // Фарбуємо чорним усіх порожніх сусідів (клітинки області вже позначені FILLED або числом, рамка не порожня)
+        for (const int *it = begin; it != end; ++it) {
             for (int d = 0; d < 4; ++d) {
-                int nr = r + DX_[d], nc = c + DY_[d];
-                int nid = nr*cols_ + nc;
-                if (out_of_bounds(nr,nc) || current[nr][nc]==BLACK || path[nid]) continue;
-                current[nr][nc] = BLACK;
+                int nid = *it + dir_[d];
+                if (current[nid] == EMPTY) change(nid, BLACK);
             }
         }
-        steps.push_back(current);
+        ++step.number;
+        on_step(step);
     }
 
     // Фінальне заповнення решти порожніх
-    for (int r = 0; r < rows_; ++r) {
-        for (int c = 0; c < cols_; ++c) {
-            if (current[r][c] == EMPTY) {
-                current[r][c] = BLACK;
-            }
-        }
+    step.changes.clear();
+    for (int id = 0; id < size_; ++id) {
+        if (current[id] == EMPTY) change(id, BLACK);
     }
-    steps.push_back(current);
-    return steps;
+    ++step.number;
+    on_step(step);
+}
+
+// Метод для додавання області до рішення
+void nurikabe_solver::push_solution(const Path &path) {
+    solution_cells_.insert(solution_cells_.end(), path.begin(), path.end());
+    solution_ends_.push_back(static_cast<int>(solution_cells_.size()));
 }
 
 // Метод для зібрання клітинок з числами в список
-void nurikabe_solver::collect_numbers(std::vector<cell> &cells) {
+void nurikabe_solver::collect_numbers(std::vector<int> &cells) {
     cells.clear();
-    for (int r = 0; r < rows_; ++r) {
-        for (int c = 0; c < cols_; ++c) {
-            int id = r*cols_ + c;
-            if (grid_[r][c] > 0 && !used_[id]) {
-                cells.emplace_back(r,c);
-            }
+    for (int id = 0; id < size_; ++id) {
+        if (grid_[id] > 0 && !used_[id]) {
+            cells.push_back(id);
         }
     }
 }
 
 // Метод для знаходження всіх можливих шляхів (областей) з однієї числової клітини
 std::vector<nurikabe_solver::Path>
-nurikabe_solver::find_all_valid_paths(cell start, int totalSize) {
-    using Path = std::vector<char>;
-    /* 
-        Створюємо множину унікальних шляхів, prev для шляхів довжини k і curr для шляхів довжини k+1
-        Кожен шлях - це бітова маска, яка вказує які клітинки входять в поточну білу область
+nurikabe_solver::find_all_valid_paths(int start, int totalSize) {
+    /*
+        Перебір зв'язних областей за Редельмаєром: кожна область генерується рівно один раз,
+        тому не потрібні ні множина для видалення дублікатів, ні копіювання масок на кожному кроці.
+        region_ — поточна область, untried_ — клітинки, які ще можна до неї додати,
+        reached_ — клітинки, які вже потрапляли до untried_ на цій гілці перебору
+    */
+    std::vector<Path> result;
+    path_limit_ = std::numeric_limits<int>::max();
+    enumerate_regions(start, totalSize, &result);
+    return result;
+}
+
+// Метод для підрахунку областей числа без їх збереження
+int nurikabe_solver::count_valid_paths(int start, int total_size, int limit) {
+    path_limit_ = limit;
+    enumerate_regions(start, total_size, nullptr);
+    return path_count_;
+}
+
+// Спільна частина перебору областей для find_all_valid_paths і count_valid_paths
+void nurikabe_solver::enumerate_regions(int start, int total_size, std::vector<Path> *result) {
+    // Область не виходить за межі карти досяжності числа, тож актуалізуємо її перед перебором
+    if (reach_ready_ && reach_dirty_[clue_slot_[start]]) refresh_reach(clue_slot_[start]);
+
+    path_count_ = 0;
+    region_.assign(1, start);
+    reached_[start] = 1;
+    in_path_[start] = 1;
+    if (total_size <= 1) {
+        if (!region_touches_white()) {
+            ++path_count_;
+            if (result) result->push_back(region_);
+        }
+        reached_[start] = 0;
+        in_path_[start] = 0;
+        return;
+    }
+
+    // Початкові кандидати — допустимі сусіди клітинки з числом
+    untried_.clear();
+    for (int d = 0; d < 4; ++d) {
+        int nid = start + dir_[d];
+        if (!region_can_take(nid, start)) continue;
+        reached_[nid] = 1;
+        untried_.push_back(nid);
+    }
+
+    grow_region(0, start, total_size, result);
+
+    // Прибираємо позначки, щоб буфери можна було використати для наступного числа
+    for (int idx : untried_) reached_[idx] = 0;
+    untried_.clear();
+    reached_[start] = 0;
+    in_path_[start] = 0;
+}
+
+// Метод для рекурсивного розширення області клітинками з untried_[from..)
+void nurikabe_solver::grow_region(int from, int start, int total_size, std::vector<Path> *result) {
+    /*
+        Діапазон кандидатів поточного рівня завжди лежить у кінці untried_, тому нові сусіди просто дописуються в кінець,
+        і дочірній рівень отримує діапазон [i + 1, кінець) без копіювання.
+        Спробувані клітинки лишаються позначеними в reached_ до кінця циклу — саме це гарантує унікальність областей
     */
-    std::unordered_set<Path, PathHash, PathEq> prev, curr;
-
-    // Ініціалізуємо prev шляхом з однієї стартової клітини
-    Path init(rows_ * cols_, 0);
-    init[start.row * cols_ + start.col] = 1;
-    prev.insert(init);
-
-    // Шукаємо всі шляхи довжини від 1 до totalSize
-    for (int len = 1; len < totalSize; ++len) {
-        for (const auto &mask : prev) {
-            // Пробуємо розширитися з усіх клітинок поточного шляху
-            for (int idx = 0; idx < rows_ * cols_; ++idx) {
-                if (!mask[idx]) continue;
-                int r = idx / cols_, c = idx % cols_;
-                for (int d = 0; d < 4; ++d) {
-                    int nr = r + DX_[d], nc = c + DY_[d];
-                    int nid = nr * cols_ + nc;
-                    // Якщо клітинка за межами поля, або це чорна клітинка, або вона вже належить до шляху — пропускаємо
-                    if (out_of_bounds(nr, nc) || grid_[nr][nc] == BLACK || mask[nid]) continue;
-                    cell nb(nr, nc);
-                    // Перевірка: чи не має клітинка сусідів з числами (щоб не захопити інше число)
-                    if (!is_expandable(nb, start, mask)) continue;
-                    // Додаємо нову клітинку до поточного шляху
-                    Path np = mask;
-                    np[nid] = 1;
-                    curr.insert(std::move(np));
-                }
+    int to = static_cast<int>(untried_.size());
+    for (int i = from; i < to && path_count_ < path_limit_; ++i) {
+        int idx = untried_[i];
+        region_.push_back(idx);
+        in_path_[idx] = 1;
+
+        if (static_cast<int>(region_.size()) == total_size) {
+            // Біла клітинка поруч з областю мусить належати їй, інакше її довелося б пофарбувати
+            if (!region_touches_white()) {
+                ++path_count_;
+                if (result) result->push_back(region_);
             }
+        } else {
+            for (int d = 0; d < 4; ++d) {
+                int nid = idx + dir_[d];
+                if (reached_[nid] || !region_can_take(nid, start)) continue;
+                reached_[nid] = 1;
+                untried_.push_back(nid);
+            }
+            grow_region(i + 1, start, total_size, result);
+
+            // Знімаємо позначки з сусідів, доданих на цьому рівні
+            for (int k = to; k < static_cast<int>(untried_.size()); ++k) reached_[untried_[k]] = 0;
+            untried_.resize(to);
         }
-        // Переходимо до наступного кроку розширення
-        prev.swap(curr);
-        curr.clear();
+
+        in_path_[idx] = 0;
+        region_.pop_back();
     }
+}
 
-    // Зберігаємо результат в вектор
-    std::vector<Path> result;
-    for (const auto &p : prev) result.push_back(p);
-    return result;
+// Метод для перевірки, чи область region_ межує з білою клітинкою поза нею
+bool nurikabe_solver::region_touches_white() const {
+    for (int idx : region_) {
+        for (int d = 0; d < 4; ++d) {
+            int nid = idx + dir_[d];
+            if (grid_[nid] == WHITE && !in_path_[nid]) return true;
+        }
+    }
+    return false;
 }
 
-// Метод для перевірки наявності інших клітинок з числами крім end для заданої клітинки
-bool nurikabe_solver::is_expandable(cell a, cell end, const Path &path) const {
+// Метод для перевірки, чи клітинка може увійти в область числа end: вона не чорна, не рамка, не є іншим числом і не межує з іншими числами
+bool nurikabe_solver::is_expandable(int a, int end) const {
+    if (grid_[a] == BLACK || grid_[a] == flat_grid::BORDER || grid_[a] > 0) return false;
     for (int d = 0; d < 4; ++d) {
-        int nr = a.row + DX_[d], nc = a.col + DY_[d];
-        int nid = nr*cols_ + nc;
-        if (out_of_bounds(nr,nc) || grid_[nr][nc]==BLACK || path[nid]) continue;
-        if (grid_[nr][nc]>0 && !(cell(nr,nc)==end)) return false;
+        int nid = a + dir_[d];
+        if (grid_[nid]>0 && nid != end) return false;
     }
     return true;
 }
 
-// Метод для перевірки меж для заданих координат
-bool nurikabe_solver::out_of_bounds(int r, int c) const {
-    return r<0 || c<0 || r>=rows_ || c>=cols_;
+// Метод для перевірки кандидата на розширення області: карта досяжності вже враховує is_expandable і відстань
+bool nurikabe_solver::region_can_take(int id, int start) const {
+    return reach_ready_ ? in_reach(start, id) : is_expandable(id, start);
 }
 
-// Метод для фарбування сусідніх клітинок області в чорний колір і попереднє збереження їх в список "painted" для майбутнього можливого відновлення
-void nurikabe_solver::paint_adjacent(const Path &path, std::vector<char> &painted) {
-    for (int idx = 0; idx < rows_*cols_; ++idx) {
-        if (!path[idx]) continue;
-        int r = idx/cols_, c = idx%cols_;
+// Метод для фарбування сусідніх клітинок області в чорний колір (старі значення зберігаються в журналі змін)
+void nurikabe_solver::paint_adjacent(const Path &path) {
+    for (int idx : path) in_path_[idx] = 1;
+    for (int idx : path) {
         for (int d = 0; d < 4; ++d) {
-            int nr = r + DX_[d], nc = c + DY_[d];
-            int nid = nr*cols_ + nc;
-            if (out_of_bounds(nr,nc) || grid_[nr][nc]==BLACK || path[nid]) continue;
-            grid_[nr][nc] = BLACK;
-            painted[nid] = 1;
+            int nid = idx + dir_[d];
+            if (grid_[nid]==BLACK || grid_[nid]==flat_grid::BORDER || in_path_[nid]) continue;
+            set_cell(nid, BLACK);
         }
     }
+    for (int idx : path) in_path_[idx] = 0;
 }
 
 // Метод для перевірки зв'язності чорної області
 bool nurikabe_solver::is_black_area_connected() const {
-    // Список visited для зберігання пройдених клітинок
-    std::vector<char> vis(rows_*cols_, 0);
-    // st - стартова клітинка, found - чи була знайдена стартова клітинка, cnt - кількість чорних клітинок
-    int start = -1, cnt = 0;
-    for (int r = 0; r < rows_; ++r) {
-        for (int c = 0; c < cols_; ++c) {
-            int id = r*cols_ + c;
-            /*
-                Тут дуже цікавий момент, так як пусті клітинки в майбутньому можуть стати чорними, ми їх також рахуємо за чорні,
-                не рахуємо тільки заповнені і клітинки з цифрами
-            */
-            if (grid_[r][c]==BLACK || grid_[r][c]==EMPTY) {
-                if (start<0) start = id;
-                ++cnt;
-            }
+    /*
+        Тут дуже цікавий момент, так як пусті клітинки в майбутньому можуть стати чорними, ми їх також рахуємо за чорні,
+        не рахуємо тільки заповнені і клітинки з цифрами. Заливка виконується по бітових рядках
+    */
+    return board_.is_open_area_connected();
+}
+
+// Метод для локальної перевірки зв'язності чорної області після заповнення клітинок області path
+bool nurikabe_solver::is_black_area_still_connected(const Path &path) {
+    /*
+        Будь-який шлях між чорними/порожніми клітинками, що проходив через path, входив і виходив через її сусідів.
+        Тому зв'язність зберігається тоді й лише тоді, коли всі такі сусіди досяжні один з одного
+    */
+    unsigned target = next_stamp();
+    int targets = 0, first = -1;
+    for (int idx : path) {
+        for (int d = 0; d < 4; ++d) {
+            int nid = idx + dir_[d];
+            if (target_mark_[nid] == target) continue;
+            if (grid_[nid]!=BLACK && grid_[nid]!=EMPTY) continue;
+            target_mark_[nid] = target;
+            if (first < 0) first = nid;
+            ++targets;
+        }
+    }
+    if (targets <= 1) return true;
+
+    // Ітеративний обхід в ширину від першого сусіда, зупиняємося, щойно знайдено всіх
+    unsigned visit = next_stamp();
+    int head = 0, tail = 0;
+    bfs_queue_[tail++] = first;
+    visit_mark_[first] = visit;
+    int found = 1;
+    while (head < tail) {
+        int id = bfs_queue_[head++];
+        for (int d = 0; d < 4; ++d) {
+            int nid = id + dir_[d];
+            if (visit_mark_[nid] == visit) continue;
+            if (grid_[nid]!=BLACK && grid_[nid]!=EMPTY) continue;
+            visit_mark_[nid] = visit;
+            if (target_mark_[nid] == target && ++found == targets) return true;
+            bfs_queue_[tail++] = nid;
         }
     }
-    // Якщо не було знайдено ні одної чорної клітинки, повератаємо true, так як технічно нульова область також зв'язна
-    if (start<0) return true;
+
+    // Область розпалася — це суперечність лише тоді, коли чорні клітинки опинились у різних частинах
+    return resolve_open_pockets();
+}
+
+// Метод для отримання нової мітки обходу
+unsigned nurikabe_solver::next_stamp() {
+    if (++stamp_ == 0) {
+        std::fill(target_mark_.begin(), target_mark_.end(), 0);
+        std::fill(visit_mark_.begin(), visit_mark_.end(), 0);
+        stamp_ = 1;
+    }
+    return stamp_;
+}
+
+// Метод для оновлення лічильників чорних клітинок у вікнах 2x2 навколо клітинки
+void nurikabe_solver::count_black_windows(int id, int delta) {
     /*
-        Перевіряємо чи збігається кількість усіх чорних клітинок з кількістю досяжних клітинок починаючи з start
-        (якщо область зв'язна, вони повинні співпадати)
+        Вікна з лівим верхнім кутом id, id - 1, id - stride, id - stride - 1 містять клітинку.
+        Вікна, що зачіпають рамку, ніколи не стануть повністю чорними, тож перевірка меж не потрібна
     */
-    return dfs_count_black(vis, {start/cols_, start%cols_}) == cnt;
+    const int corners[4] = { id, id + dir_[2], id + dir_[0], id + dir_[0] + dir_[2] };
+    for (int w : corners) {
+        unsigned char &cnt = window_black_[w];
+        if (cnt == 4) --full_windows_;
+        cnt = static_cast<unsigned char>(cnt + delta);
+        if (cnt == 4) ++full_windows_;
+    }
 }
 
-// Метод для підрахунку всіх досяжних чорних клітинок починаючи з start
-int nurikabe_solver::dfs_count_black(std::vector<char> &vis, cell c) const {
-    int id = c.row*cols_ + c.col;
-    vis[id] = 1;
-    int sum = 1;
-    for (int d = 0; d < 4; ++d) {
-        int nr = c.row + DX_[d], nc = c.col + DY_[d];
-        int nid = nr*cols_ + nc;
-        if (out_of_bounds(nr,nc) || vis[nid]) continue;
-        if (grid_[nr][nc]!=BLACK && grid_[nr][nc]!=EMPTY) continue;
-        sum += dfs_count_black(vis, {nr,nc});
-    }
-    return sum;
+// Метод для запису значення клітинки із збереженням старого значення в журналі змін
+void nurikabe_solver::set_cell(int id, int value) {
+    trail_.emplace_back(id, grid_[id]);
+    write_cell(id, value);
 }
 
-// Метод для перевірки існування чорних блоків 2x2
-bool nurikabe_solver::has_black_2x2_block() const {
-    for (int r = 0; r+1 < rows_; ++r) {
-        for (int c = 0; c+1 < cols_; ++c) {
-            if (grid_[r][c]==BLACK && grid_[r+1][c]==BLACK &&
-                grid_[r][c+1]==BLACK && grid_[r+1][c+1]==BLACK) {
-                return true;
-            }
-        }
+// Метод для відкату журналу змін до позиції mark у зворотному порядку
+void nurikabe_solver::undo_to(size_t mark) {
+    while (trail_.size() > mark) {
+        auto [idx, old] = trail_.back();
+        trail_.pop_back();
+        write_cell(idx, old);
     }
-    return false;
 }
 
-// Метод для заповнення можливих пропусків в кінці і попередній запис їх в список spaces для майбутнього можливого відновлення
-void nurikabe_solver::fill_spaces(std::vector<cell> &spaces) {
-    spaces.clear();
-    for (int r = 0; r < rows_; ++r) {
-        for (int c = 0; c < cols_; ++c) {
-            if (grid_[r][c]==EMPTY) {
-                spaces.emplace_back(r,c);
-                grid_[r][c] = BLACK;
-            }
+// Метод для запису значення клітинки, бітове представлення оновлюється разом з сіткою
+void nurikabe_solver::write_cell(int id, int value) {
+    // Новий чорний квадрат 2x2 може з'явитися лише у вікнах, що містять змінену клітинку
+    if ((grid_[id] == BLACK) != (value == BLACK))
+        count_black_windows(id, value == BLACK ? 1 : -1);
+    if (candidates_ready_) update_candidates(id, grid_[id], value);
+    if (reach_ready_) touch_reach(id, grid_[id], value);
+    grid_[id] = value;
+    board_.set(grid_.row_of(id), grid_.col_of(id), value);
+}
+
+// Метод для заповнення можливих пропусків в кінці (старі значення зберігаються в журналі змін)
+void nurikabe_solver::fill_spaces() {
+    for (int id = 0; id < size_; ++id) {
+        if (grid_[id]==EMPTY) {
+            set_cell(id, BLACK);
         }
     }
 }
@@ -3,9 +3,32 @@
 
 #include <vector>
 #include <iostream>
-#include <stack>
+#include <functional>
 #include <set>
-#include "Cell.hpp"
+#include <utility>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "flat_grid.hpp"
+#include "bit_board.hpp"
+#include "solver_stats.hpp"
+
+/*
+    Пошук перервано через обмеження часу, кількості вузлів або зовнішнє скасування — до того, як доведено,
+    є рішення чи ні. На відміну від runtime_error("Рішення не існує"), нічого не каже про саму задачу
+*/
+class solve_interrupted : public std::runtime_error {
+public:
+    enum class reason { TIME_LIMIT, NODE_LIMIT, CANCELLED };
+
+    explicit solve_interrupted(reason why);
+
+    // Причина переривання
+    reason why() const { return why_; }
+
+private:
+    reason why_;
+};
 
 // Клас, що реалізує розв'язувач головоломки Nurikabe (пари чисел)
 class nurikabe_solver {
@@ -14,78 +37,366 @@ public:
     enum cell_state : int {
         EMPTY = 0,     // порожня клітинка
         BLACK = -1,    // чорна (вода)
-        FILLED = -2    // заповнена клітинка острова (не число)
+        FILLED = -2,   // заповнена клітинка острова (не число)
+        WHITE = -4     // клітинка точно біла, але її острів ще не визначено (висновок поширення обмежень)
     };
 
     // Скорочена назва для сітки
-    using grid = std::vector<std::vector<int>>;
-    // Одновимірна бітова маска шляху
-    using Path = std::vector<char>;
-
-    // Хеш та рівність для Path
-    struct PathHash {
-        size_t operator()(Path const &p) const noexcept {
-            size_t h = 146527;
-            for (unsigned char c : p) {
-                h = h * 31 + c;
-            }
-            return h;
-        }
+    using grid = flat_grid;
+    // Область як список індексів клітинок у flat_grid, перша клітинка — число області
+    using Path = std::vector<int>;
+
+    nurikabe_solver() = default;
+
+    // Більше цієї кількості областей при виборі числа для розгалуження не рахуємо — такі числа рівноцінні
+    static constexpr int BRANCH_COUNT_LIMIT = 256;
+
+    // Числа, що мають більше варіантів області, не отримують заздалегідь побудованого списку і перебираються щоразу
+    static constexpr int CANDIDATE_LIMIT = 2048;
+
+    // Скільки вузлів може перебрати малий розв'язувач (nurikabe_small.hpp), перш ніж задачу отримає загальний
+    static constexpr long long SMALL_NODE_BUDGET = 20000;
+
+    // Клітинка, яку змінив крок рішення
+    struct cell_change {
+        int row;
+        int col;
+        int value;
     };
-    struct PathEq {
-        bool operator()(Path const &a, Path const &b) const noexcept {
-            return a == b;
-        }
+
+    // Крок покрокового рішення: лише клітинки, змінені відносно попереднього кроку
+    struct solve_step {
+        int number = 0;                     // номер кроку, починаючи з 1
+        int total = 0;                      // кількість кроків рішення
+        std::vector<cell_change> changes;
     };
 
-    nurikabe_solver() = default;
+    // Обробник кроків рішення; буфер changes перевикористовується, тож крок дійсний лише під час виклику
+    using step_callback = std::function<void(const solve_step &)>;
 
     // Запускає розв'язання задачі та повертає послідовність проміжних станів
     std::vector<grid> solve(const grid initial);
 
+    // Розв'язує задачу і передає кроки рішення в on_step по одному, не зберігаючи проміжних сіток
+    void solve(const grid initial, const step_callback &on_step);
+
+    /*
+        Рахує рішення задачі, продовжуючи пошук після кожного знайденого, і зупиняється, щойно їх набереться limit.
+        Повертає кількість знайдених рішень (не більше limit; 0 — рішення немає). Відсічення ті самі, що й у solve
+    */
+    int count_solutions(const grid initial, int limit = 2);
+
+    // Обробник знайденого рішення: розв'язана сітка дійсна лише під час виклику
+    using solution_callback = std::function<void(const grid &)>;
+
+    // Те саме, але кожне знайдене рішення передається в on_solution (наприклад, щоб знайти, чим рішення відрізняються)
+    int count_solutions(const grid initial, int limit, const solution_callback &on_solution);
+
+    // Чи має задача рівно одне рішення (пошук зупиняється на другому)
+    bool is_unique(const grid initial) { return count_solutions(initial, 2) == 1; }
+
+    /*
+        Паралельне розв'язання (nurikabe_parallel.cpp): кожен потік має власну копію розв'язувача,
+        вільні потоки забирають неперевірені гілки пошуку в інших, перше знайдене рішення зупиняє всіх.
+        threads = 0 — за кількістю ядер. Для задач з кількома рішеннями може повернути інше рішення, ніж solve
+    */
+    std::vector<grid> solve_parallel(const grid initial, unsigned threads = 0);
+
+    // Паралельне розв'язання з передачею кроків у on_step, як у solve
+    void solve_parallel(const grid initial, const step_callback &on_step, unsigned threads = 0);
+
+    // Застосовує крок до сітки: повна сітка будь-якого кроку будується на вимогу з початкової
+    static void apply_step(grid &g, const solve_step &step);
+
+    /*
+        Вмикає збір статистики пошуку в stats (nullptr — вимикає). solve і solve_parallel обнуляють її на початку,
+        тож після розв'язання stats описує саме його. Об'єкт має жити, поки розв'язувач ним користується
+    */
+    void set_stats(solver_stats *stats) { stats_ = stats; }
+
+    /*
+        Обмеження пошуку для solve, solve_parallel і count_solutions. Вони перевіряються в кожному вузлі пошуку;
+        при перевищенні розв'язання завершується винятком solve_interrupted.
+        Обмеження часу в секундах і кількість вузлів (у паралельному режимі — сумарно для всіх потоків), 0 — без обмеження
+    */
+    void set_time_limit(double seconds) { time_limit_ = seconds; }
+    void set_node_limit(long long nodes) { node_limit_ = nodes; }
+
+    // Зовнішній прапорець скасування: щойно він стає true, пошук перериватиметься (nullptr — не перевіряється)
+    void set_cancel_token(const std::atomic<bool> *token) { cancel_ = token; }
+
+    /*
+        solve і solve_parallel спершу пробують розв'язувач для сіток, що вміщуються в 64 або 128 біт
+        (nurikabe_small.hpp), і переходять до загального, якщо задача не вміщується або виявилась заважкою.
+        Зі статистикою завжди працює загальний. Для задач з кількома рішеннями може повернути інше рішення
+    */
+    void set_small_engine(bool enabled) { small_engine_ = enabled; }
+
+    // Рушій розв'язання для solve і solve_parallel
+    enum class engine {
+        NATIVE,   // власний пошук з поверненнями
+        SAT       // кодування в CNF і вбудований CDCL-розв'язувач (nurikabe_sat.cpp)
+    };
+
+    /*
+        Вибирає рушій. SAT-рушій працює в одному потоці; обмеження вузлів і статистика nodes рахують у ньому конфлікти.
+        count_solutions завжди використовує власний пошук
+    */
+    void set_engine(engine e) { engine_ = e; }
+    engine current_engine() const { return engine_; }
+
 private:
+    // Мікробенчмарки (nurikabe_bench.cpp) вимірюють приватні примітиви напряму
+    friend struct nurikabe_bench;
+
+    // Спільний стан потоків паралельного пошуку (визначений у nurikabe_parallel.cpp)
+    struct parallel_search;
+
+    // Заздалегідь побудований варіант області числа
+    struct candidate {
+        int clue;     // клітинка з числом
+        int kills;    // кількість клітинок, стан яких зараз суперечить варіанту (0 — варіант допустимий)
+        int begin;    // клітинки області — cand_cells_[begin, mid), число першим
+        int mid;      // клітинки межі області — cand_cells_[mid, end)
+        int end;
+    };
+
     int rows_ = 0;
     int cols_ = 0;
+    int size_ = 0;          // розмір масиву сітки разом з рамкою
 
     grid grid_;             // робоча копія сітки
+    bit_board board_;       // бітове представлення робочої сітки (синхронізується з grid_)
+    std::vector<unsigned char> window_black_; // кількість чорних клітинок у вікні 2×2 з лівим верхнім кутом id
+    int full_windows_ = 0;                    // кількість повністю чорних вікон 2×2
+    std::vector<std::pair<int, int>> trail_;  // журнал змін: (індекс клітинки, старе значення)
     grid initial_grid_;     // початкова сітка
-    std::vector<char> used_;                  // позначення використаних чисел (rows_*cols_)
-    std::stack<Path>     path_stack_;         // стек для відновлення покрокового рішення
+    std::vector<char> used_;                  // позначення використаних чисел (size_)
+    std::vector<char> reached_;               // клітинки, вже додані до множини кандидатів при переборі областей (size_)
+    std::vector<char> in_path_;               // тимчасова маска клітинок поточної області (size_)
+    std::vector<int>  untried_;               // буфер ще не спробуваних клітинок перебору областей
+    Path              region_;                // область, що будується під час перебору
+    int path_count_ = 0;                      // кількість знайдених областей у поточному переборі
+    int path_limit_ = 0;                      // після скількох знайдених областей перебір зупиняється
+
+    unsigned stamp_ = 0;                      // поточна мітка для target_mark_ / visit_mark_
+    std::vector<unsigned> target_mark_;       // мітки клітинок межі області при локальній перевірці зв'язності
+    std::vector<unsigned> visit_mark_;        // мітки відвіданих клітинок при локальній перевірці зв'язності
+    std::vector<int> bfs_queue_;              // черга обходу в ширину (size_)
+    bool reach_ready_ = false;                // чи підтримуються карти досяжності (nurikabe_reachability.cpp)
+    std::vector<int> clue_slot_;              // номер карти досяжності числа id або -1 (size_)
+    std::vector<int> slot_clue_;              // число, якому належить карта
+    std::vector<std::vector<int>> reach_dist_;  // відстань від числа до клітинки в межах його області або -1 (карта × size_)
+    std::vector<std::vector<int>> reach_cells_; // клітинки, які зараз містить карта
+    std::vector<char> reach_dirty_;           // карта застаріла і має бути перебудована перед використанням
+    std::vector<int> near_start_;             // карти, коренева версія яких містить клітинку id: near_list_[near_start_[id], near_start_[id + 1])
+    std::vector<int> near_list_;
+    std::vector<int> cover_;                  // кількість невикористаних чисел, що досягають клітинки (size_)
+    std::vector<int> new_white_;              // клітинки, що стали WHITE під час поточного поширення обмежень
+    std::vector<int> forced_;                 // клітинки, вимушені правилом, які фарбуються після проходу
+    std::vector<int> solution_cells_;         // клітинки областей рішення підряд, від найглибшої області до кореня
+    std::vector<int> solution_ends_;          // кінець кожної області рішення в solution_cells_
+    std::vector<const Path *> decisions_;     // області, зафіксовані на шляху від кореня до поточного вузла пошуку
+
+    bool candidates_ready_ = false;           // чи підтримуються списки варіантів (nurikabe_candidates.cpp)
+    std::vector<candidate> candidates_;       // варіанти областей усіх чисел зі списками, згруповані за числом
+    std::vector<int> cand_cells_;             // клітинки областей і меж варіантів
+    std::vector<int> member_start_;           // варіанти, що містять клітинку id: member_list_[member_start_[id], member_start_[id + 1])
+    std::vector<int> member_list_;
+    std::vector<int> halo_start_;             // варіанти, межа яких містить клітинку id: halo_list_[halo_start_[id], halo_start_[id + 1])
+    std::vector<int> halo_list_;
+    std::vector<int> clue_begin_;             // перший варіант числа id в candidates_ або -1, якщо списку немає (size_)
+    std::vector<int> clue_end_;               // кінець діапазону варіантів числа id (size_)
+    std::vector<int> alive_;                  // кількість допустимих варіантів числа id (size_)
+    std::vector<int> listed_clues_;           // числа, для яких побудовано списки
+
+    long long nodes_ = 0;                     // кількість вузлів пошуку з початку розв'язання
+    solver_stats *stats_ = nullptr;           // статистика пошуку (nullptr — не збирається)
+    int count_limit_ = 0;                     // режим підрахунку рішень: до скількох рахувати (0 — пошук першого рішення)
+    int solutions_ = 0;                       // кількість рішень, знайдених у режимі підрахунку
+    const solution_callback *on_solution_ = nullptr; // обробник рішень у режимі підрахунку (nullptr — не потрібен)
+
+    double time_limit_ = 0;                   // обмеження часу розв'язання в секундах (0 — немає)
+    long long node_limit_ = 0;                // обмеження кількості вузлів пошуку (0 — немає)
+    const std::atomic<bool> *cancel_ = nullptr; // зовнішній прапорець скасування
+    bool limits_active_ = false;              // чи задано хоч одне обмеження в поточному розв'язанні
+    std::chrono::steady_clock::time_point deadline_; // момент, після якого пошук переривається
+    bool interrupted_ = false;                // пошук перервано через обмеження
+    solve_interrupted::reason interrupt_reason_ = solve_interrupted::reason::CANCELLED;
+
+    bool small_engine_ = true;                // чи пробувати спершу малий розв'язувач
+    engine engine_ = engine::NATIVE;          // рушій solve і solve_parallel
+
+    parallel_search *shared_ = nullptr;       // спільний стан паралельного пошуку (nullptr у звичайному режимі)
+    unsigned worker_ = 0;                     // номер потоку цього розв'язувача в паралельному пошуку
 
-    // Зміщення по 4 напрямках: вверх, вниз, вліво, вправо
-    static constexpr int DX_[4] = { -1, 1, 0, 0 };
-    static constexpr int DY_[4] = {  0, 0,-1, 1 };
+    // Зміщення індексу по 4 напрямках: вверх, вниз, вліво, вправо (залежать від ширини сітки)
+    int dir_[4] = { 0, 0, 0, 0 };
+
+    // Ініціалізує робочий стан для сітки initial і виконує висновки в корені, false — рішення не існує
+    bool prepare(const grid &initial);
+
+    // Повертає глобальні поля в початковий стан
+    void release();
+
+    // Розв'язує задачу малим розв'язувачем (nurikabe_small.cpp); false — вона йому не підходить
+    bool solve_small(const grid &initial, const step_callback &on_step);
+
+    // Розв'язує задачу SAT-рушієм (nurikabe_sat.cpp) і передає кроки рішення; без рішення кидає виняток, як solve
+    void solve_sat(const grid &initial, const step_callback &on_step);
+
+    // Рахує відсічення гілки з причиною cause, якщо статистика ввімкнена, і повертає false
+    bool prune(long long solver_stats::*cause);
 
     // Основний рекурсивний метод для пошуку рішення
     bool solve_recurse();
 
-    // Відновлення кроків розв'язку за шляхами зі стеку
-    std::vector<grid> recover_step_by_step();
+    // Фіксує область path (число — path[0]) з її чорною межею і перевіряє новий стан
+    bool apply_region(const Path &path);
 
-    // Збирає координати ще не використаних чисел на сітці
-    void collect_numbers(std::vector<cell> &cells);
+    // Віддає області paths[next..] вільним потокам; false — пошук скасовано
+    bool poll_parallel(std::vector<Path> &paths, size_t next);
+
+    // Цикл потоку паралельного пошуку: бере гілки зі спільних черг, поки вони є і рішення не знайдено
+    void run_worker(parallel_search &shared, unsigned index);
+
+    // Додає область до рішення (викликається при поверненні з успішної гілки, тож області йдуть від найглибшої)
+    void push_solution(const Path &path);
+
+    // Відновлення кроків розв'язку за областями рішення: кожен крок передається в on_step лише змінами
+    void recover_step_by_step(const step_callback &on_step);
+
+    // Збирає індекси ще не використаних чисел на сітці
+    void collect_numbers(std::vector<int> &cells);
 
     // Повертає всі допустимі шляхи між двома числами, які можна з'єднати
-    std::vector<Path> find_all_valid_paths(cell start, int total_size);
+    std::vector<Path> find_all_valid_paths(int start, int total_size);
+
+    // Рахує допустимі області числа start, зупиняючись, щойно їх набралося limit
+    int count_valid_paths(int start, int total_size, int limit);
+
+    // Перебирає області числа start: зберігає їх у result (якщо він не nullptr) і рахує в path_count_
+    void enumerate_regions(int start, int total_size, std::vector<Path> *result);
+
+    // Рекурсивно розширює region_ клітинками з untried_[from, untried_.size()) (перебір Редельмаєра)
+    void grow_region(int from, int start, int total_size, std::vector<Path> *result);
+
+    /*
+        Вибирає число для розгалуження: з найменшою кількістю допустимих областей (MRV),
+        при рівності — з більшою кількістю сусідніх чисел, з якими його область може перетнутися.
+        Повертає -1, якщо якесь число вже не має жодної області
+    */
+    int select_branch_clue(const std::vector<int> &nums);
+
+    /*
+        Списки варіантів (nurikabe_candidates.cpp): усі області числа будуються один раз після висновків у корені,
+        далі write_cell лише змінює лічильники kills варіантів, яких торкається змінена клітинка.
+        Відкат журналу проходить через той самий write_cell, тож лічильники відновлюються симетрично
+    */
+    void build_candidates();
+
+    // Перераховує kills варіантів, що містять клітинку id, при зміні її значення з old_value на value
+    void update_candidates(int id, int old_value, int value);
+
+    // Допустимі області числа: зі списку, якщо він є, інакше повним перебором
+    std::vector<Path> candidate_paths(int clue);
+
+    // Кількість допустимих областей числа, не більше limit
+    int candidate_count(int clue, int limit);
+
+    // Чи є невикористане число, у списку якого не лишилося жодного допустимого варіанту
+    bool has_dead_clue() const;
+
+    // Кількість інших невикористаних чисел, області яких можуть торкнутися області числа id
+    int clue_degree(int id, const std::vector<int> &nums) const;
+
+    // Перевіряє, чи клітинка може бути додана до області з числом у клітинці end
+    bool is_expandable(int a, int end) const;
 
-    // Перевіряє, чи клітинка може бути додана до поточного шляху
-    bool is_expandable(cell a, cell end, const Path &path) const;
+    // Перевіряє, чи поточна область region_ межує з WHITE клітинкою, яку вона не містить
+    bool region_touches_white() const;
 
-    // Перевіряє, чи координати виходять за межі поля
-    bool out_of_bounds(int r, int c) const;
+    // Записує значення клітинки і додає її старе значення в журнал змін trail_
+    void set_cell(int id, int value);
+
+    // Відкочує всі зміни з журналу, зроблені після позиції mark
+    void undo_to(size_t mark);
+
+    // Фіксує обмеження на початку розв'язання: рахує момент завершення за time_limit_
+    void start_limits();
+
+    // Перевіряє обмеження у вузлі пошуку; false — пошук треба перервати (причина — в interrupt_reason_)
+    bool within_limits();
+
+    // Кидає solve_interrupted, якщо пошук було перервано (після release)
+    void throw_if_interrupted() const;
+
+    // Записує значення клітинки в робочу сітку та її бітове представлення без запису в журнал
+    void write_cell(int id, int value);
 
     // Фарбує сусідні клітинки шляху в чорний колір
-    void paint_adjacent(const Path &path, std::vector<char> &painted);
+    void paint_adjacent(const Path &path);
 
     // Перевіряє, чи всі чорні клітинки утворюють єдину зв'язну область
     bool is_black_area_connected() const;
 
-    // DFS-обхід, який рахує кількість зв'язаних чорних клітинок
-    int dfs_count_black(std::vector<char> &visited, cell c) const;
+    /*
+        Інкрементальна перевірка зв'язності після того, як клітинки області path стали заповненими.
+        Якщо до цього область була зв'язною, достатньо переконатися, що сусіди path досі з'єднані між собою
+    */
+    bool is_black_area_still_connected(const Path &path);
+
+    // Повертає нову мітку для target_mark_ / visit_mark_, скидаючи їх при переповненні лічильника
+    unsigned next_stamp();
+
+    // Перевіряє наявність чорного квадрата 2×2 за лічильниками вікон, які оновлює set_cell
+    bool has_full_black_window() const { return full_windows_ > 0; }
+
+    // Змінює лічильники чорних клітинок чотирьох вікон 2×2, що містять клітинку id
+    void count_black_windows(int id, int delta);
+
+    // Тимчасово заповнює всі порожні клітинки чорним (відновлення через журнал змін)
+    void fill_spaces();
+
+    /*
+        Поширення обмежень (nurikabe_propagation.cpp): застосовує логічні правила Нурікабе до нерухомої точки.
+        Повертає false, якщо знайдено суперечність. Усі зміни записуються в журнал і відкочуються разом з гілкою
+    */
+    bool propagate();
+
+    // Фарбує в чорний клітинки, недосяжні для жодного невикористаного числа (за картами досяжності)
+    bool mark_unreachable_black();
+
+    // Будує карти досяжності всіх чисел і обернений індекс клітинка -> карти
+    void build_reach_maps();
+
+    // Перебудовує карту досяжності slot пошуком у ширину і оновлює cover_
+    void refresh_reach(int slot);
+
+    // Перебудовує всі застарілі карти досяжності
+    void refresh_reach_maps();
+
+    // Позначає застарілими карти, яких стосується зміна клітинки id з old_value на value
+    void touch_reach(int id, int old_value, int value);
+
+    // Змінює позначку використаного числа і позначає його карту застарілою
+    void set_used(int clue, char value);
+
+    // Чи містить актуальна карта числа clue клітинку id
+    bool in_reach(int clue, int id) const;
+
+    // Чи може клітинка id увійти в область числа start: за картою досяжності, якщо вона є
+    bool region_can_take(int id, int start) const;
+
+    // Обгороджує чорним острови, білі клітинки яких уже набрали потрібний розмір
+    bool wall_finished_islands();
+
+    // Робить білою єдину нечорну клітинку вікна 2×2 з трьома чорними
+    void escape_black_2x2();
 
-    // Перевіряє, чи є в сітці чорний квадрат 2×2
-    bool has_black_2x2_block() const;
+    // Продовжує чорні області, які мають лише один вихід до решти чорних клітинок
+    bool extend_black_walls();
 
-    // Тимчасово заповнює всі порожні клітинки чорним і зберігає список для відновлення
-    void fill_spaces(std::vector<cell> &spaces);
+    // Перевіряє, що всі чорні клітинки в одній частині відкритої області, а частини без чорних робить білими
+    bool resolve_open_pockets();
 };
@@ -0,0 +1,211 @@
+// puzzle_corpus.cpp
+#include "puzzle_corpus.hpp"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Читання і запис чисел little-endian незалежно від платформи
+static std::uint64_t read_le(const unsigned char *p, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) value = (value << 8) | p[i];
+    return value;
+}
+
+static void write_le(unsigned char *p, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i, value >>= 8) p[i] = static_cast<unsigned char>(value & 0xFF);
+}
+
+// Метод для перевірки сигнатури файлу
+bool puzzle_corpus::is_corpus(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// Метод для копіювання задачі в сітку
+flat_grid corpus_puzzle::to_grid() const {
+    flat_grid g(rows, cols);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c) g.at(r, c) = at(r, c);
+    return g;
+}
+
+// Створення файлу корпусу
+corpus_writer::corpus_writer(const std::string &path) : out_(path, std::ios::binary | std::ios::trunc), path_(path) {
+    if (!out_) throw std::runtime_error("Не вдалося створити файл " + path);
+
+    // Заголовок заповнюється в finish, поки що резервуємо місце
+    unsigned char header[puzzle_corpus::HEADER_SIZE] = {};
+    write(header, sizeof(header));
+}
+
+// Метод для запису байтів у файл
+void corpus_writer::write(const unsigned char *data, std::size_t size) {
+    out_.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+    if (!out_) throw std::runtime_error("Помилка запису у файл " + path_);
+    position_ += size;
+}
+
+// Метод для додавання задачі
+void corpus_writer::add(const flat_grid &puzzle) {
+    int rows = puzzle.rows(), cols = puzzle.cols();
+    if (rows <= 0 || cols <= 0 || rows > 0xFFFF || cols > 0xFFFF)
+        throw std::runtime_error("Розміри сітки не вміщуються в корпус");
+
+    int max_value = 0;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int v = puzzle.at(r, c);
+            if (v < 0 || v > 0xFFFF) throw std::runtime_error("Значення клітинки не вміщується в корпус");
+            if (v > max_value) max_value = v;
+        }
+    }
+    int cell_bytes = max_value > 0xFF ? 2 : 1;
+
+    // Запис разом з вирівнюванням до 8 байтів
+    std::size_t cells = static_cast<std::size_t>(rows) * cols;
+    std::size_t size = puzzle_corpus::RECORD_HEADER_SIZE + cells * cell_bytes;
+    buffer_.assign((size + 7) / 8 * 8, 0);
+    write_le(&buffer_[0], rows, 2);
+    write_le(&buffer_[2], cols, 2);
+    buffer_[4] = static_cast<unsigned char>(cell_bytes * 8);
+    unsigned char *p = &buffer_[puzzle_corpus::RECORD_HEADER_SIZE];
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c, p += cell_bytes) write_le(p, puzzle.at(r, c), cell_bytes);
+    }
+
+    offsets_.push_back(position_);
+    write(buffer_.data(), buffer_.size());
+}
+
+// Метод для завершення корпусу
+void corpus_writer::finish() {
+    // Індекс
+    std::uint64_t index_offset = position_;
+    unsigned char entry[8];
+    for (std::uint64_t offset : offsets_) {
+        write_le(entry, offset, 8);
+        write(entry, sizeof(entry));
+    }
+
+    // Заголовок
+    unsigned char header[puzzle_corpus::HEADER_SIZE] = {};
+    std::memcpy(header, puzzle_corpus::MAGIC, sizeof(puzzle_corpus::MAGIC));
+    write_le(&header[8], puzzle_corpus::VERSION, 4);
+    write_le(&header[16], offsets_.size(), 8);
+    write_le(&header[24], index_offset, 8);
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char *>(header), sizeof(header));
+    out_.close();
+    if (!out_) throw std::runtime_error("Помилка запису у файл " + path_);
+}
+
+// Відкриття корпусу
+corpus_reader::corpus_reader(const std::string &path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Не вдалося відкрити файл " + path);
+    file_ = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        throw std::runtime_error("Не вдалося визначити розмір файлу " + path);
+    }
+    bytes_ = static_cast<std::size_t>(size.QuadPart);
+    if (bytes_ > 0) {
+        mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_) data_ = static_cast<const unsigned char *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (!data_) {
+            close();
+            throw std::runtime_error("Не вдалося відобразити файл " + path);
+        }
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Не вдалося відкрити файл " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Не вдалося визначити розмір файлу " + path);
+    }
+    bytes_ = static_cast<std::size_t>(st.st_size);
+    if (bytes_ > 0) {
+        void *p = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Не вдалося відобразити файл " + path);
+        }
+        data_ = static_cast<const unsigned char *>(p);
+    }
+    // Відображення лишається дійсним і після закриття дескриптора
+    ::close(fd);
+#endif
+
+    // Перевірка заголовка та індексу
+    if (bytes_ < puzzle_corpus::HEADER_SIZE ||
+        std::memcmp(data_, puzzle_corpus::MAGIC, sizeof(puzzle_corpus::MAGIC)) != 0) {
+        close();
+        throw std::runtime_error("Файл " + path + " не є корпусом задач");
+    }
+    if (read_le(data_ + 8, 4) != puzzle_corpus::VERSION) {
+        close();
+        throw std::runtime_error("Непідтримувана версія корпусу " + path);
+    }
+    std::uint64_t count = read_le(data_ + 16, 8);
+    std::uint64_t index_offset = read_le(data_ + 24, 8);
+    if (index_offset < puzzle_corpus::HEADER_SIZE || index_offset > bytes_ || count > (bytes_ - index_offset) / 8) {
+        close();
+        throw std::runtime_error("Пошкоджений індекс корпусу " + path);
+    }
+    count_ = static_cast<std::size_t>(count);
+    index_ = data_ + index_offset;
+}
+
+corpus_reader::~corpus_reader() {
+    close();
+}
+
+// Метод для зняття відображення
+void corpus_reader::close() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+    mapping_ = file_ = nullptr;
+#else
+    if (data_) ::munmap(const_cast<unsigned char *>(data_), bytes_);
+#endif
+    data_ = nullptr;
+    index_ = nullptr;
+    count_ = 0;
+}
+
+// Метод для доступу до задачі за номером
+corpus_puzzle corpus_reader::at(std::size_t n) const {
+    if (n >= count_) throw std::runtime_error("Номер задачі поза межами корпусу");
+
+    std::uint64_t offset = read_le(index_ + 8 * n, 8);
+    if (offset > bytes_ || bytes_ - offset < puzzle_corpus::RECORD_HEADER_SIZE)
+        throw std::runtime_error("Пошкоджений запис корпусу");
+
+    const unsigned char *record = data_ + offset;
+    corpus_puzzle puzzle;
+    puzzle.rows = static_cast<int>(read_le(record, 2));
+    puzzle.cols = static_cast<int>(read_le(record + 2, 2));
+    puzzle.cell_bits = record[4];
+    puzzle.cells = record + puzzle_corpus::RECORD_HEADER_SIZE;
+
+    std::uint64_t cells = static_cast<std::uint64_t>(puzzle.rows) * puzzle.cols;
+    if (puzzle.rows == 0 || puzzle.cols == 0 || (puzzle.cell_bits != 8 && puzzle.cell_bits != 16) ||
+        cells * (puzzle.cell_bits / 8) > bytes_ - offset - puzzle_corpus::RECORD_HEADER_SIZE)
+        throw std::runtime_error("Пошкоджений запис корпусу");
+    return puzzle;
+}
@@ -0,0 +1,106 @@
+// puzzle_corpus.hpp
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "flat_grid.hpp"
+
+/*
+    Бінарний корпус задач. Усі числа записані в порядку little-endian.
+
+    Заголовок (32 байти): сигнатура "NURICORP", версія (u32), резерв (u32), кількість задач (u64),
+    зміщення індексу від початку файлу (u64).
+    Записи задач, кожен вирівняний на 8 байтів: рядки (u16), стовпці (u16), бітів на клітинку (u8: 8 або 16),
+    3 байти резерву, далі клітинки по рядках (u8 або u16; 0 — порожня, n > 0 — число).
+    Індекс у кінці файлу: зміщення кожного запису (u64).
+*/
+namespace puzzle_corpus {
+    constexpr char MAGIC[8] = { 'N', 'U', 'R', 'I', 'C', 'O', 'R', 'P' };
+    constexpr std::uint32_t VERSION = 1;
+    constexpr std::size_t HEADER_SIZE = 32;
+    constexpr std::size_t RECORD_HEADER_SIZE = 8;
+
+    // Чи починається файл із сигнатури корпусу
+    bool is_corpus(const std::string &path);
+}
+
+// Задача в корпусі без копіювання: клітинки читаються прямо з відображеної пам'яті
+struct corpus_puzzle {
+    int rows = 0;
+    int cols = 0;
+    int cell_bits = 8;
+    const unsigned char *cells = nullptr;
+
+    // Значення клітинки (r, c)
+    int at(int r, int c) const {
+        std::size_t i = static_cast<std::size_t>(r) * cols + c;
+        if (cell_bits == 8) return cells[i];
+        return cells[2 * i] | (cells[2 * i + 1] << 8);
+    }
+
+    // Копія задачі у вигляді сітки для розв'язувача
+    flat_grid to_grid() const;
+};
+
+// Запис корпусу: задачі додаються по одній, індекс і заголовок записуються в finish
+class corpus_writer {
+public:
+    // Створює файл корпусу; у разі помилки кидає std::runtime_error
+    explicit corpus_writer(const std::string &path);
+
+    // Додає задачу; клітинки пакуються у 8 бітів, якщо всі значення менші за 256, інакше у 16
+    void add(const flat_grid &puzzle);
+
+    // Дописує індекс і заголовок; без виклику finish файл лишається недійсним
+    void finish();
+
+    // Кількість доданих задач
+    std::size_t size() const { return offsets_.size(); }
+
+private:
+    std::ofstream out_;
+    std::string path_;
+    std::uint64_t position_ = 0;           // поточне зміщення кінця файлу
+    std::vector<std::uint64_t> offsets_;   // зміщення записів для індексу
+    std::vector<unsigned char> buffer_;    // буфер одного запису
+
+    // Записує байти у файл, перевіряючи стан потоку
+    void write(const unsigned char *data, std::size_t size);
+};
+
+/*
+    Читання корпусу через відображення файлу в пам'ять (mmap / MapViewOfFile): відкриття не читає задачі,
+    доступ до задачі n — звернення до індексу і до її запису. Заголовок та індекс перевіряються при відкритті,
+    межі запису — при зверненні; у разі помилки кидається std::runtime_error
+*/
+class corpus_reader {
+public:
+    explicit corpus_reader(const std::string &path);
+    ~corpus_reader();
+
+    corpus_reader(const corpus_reader &) = delete;
+    corpus_reader &operator=(const corpus_reader &) = delete;
+
+    // Кількість задач
+    std::size_t size() const { return count_; }
+
+    // Задача з номером n (від 0)
+    corpus_puzzle at(std::size_t n) const;
+
+private:
+    const unsigned char *data_ = nullptr; // відображений файл
+    std::size_t bytes_ = 0;               // розмір файлу
+    std::size_t count_ = 0;
+    const unsigned char *index_ = nullptr;
+#ifdef _WIN32
+    void *file_ = nullptr;
+    void *mapping_ = nullptr;
+#endif
+
+    // Знімає відображення і закриває файл
+    void close();
+};
@@ -0,0 +1,420 @@
+// sat_solver.cpp
+#include "sat_solver.hpp"
+#include <algorithm>
+
+// Послідовність Лубі (1, 1, 2, 1, 1, 2, 4, ...) — множник довжини i-го перезапуску
+static long long luby(long long i) {
+    long long size = 1, seq = 0;
+    while (size < i + 1) {
+        ++seq;
+        size = 2 * size + 1;
+    }
+    long long x = 1;
+    while (size - 1 != i) {
+        size = (size - 1) >> 1;
+        --seq;
+        i = i % size;
+    }
+    while (seq-- > 0) x *= 2;
+    return x;
+}
+
+// Метод для створення змінної
+int sat_solver::new_var() {
+    int var = var_count();
+    assigns_.push_back(UNDEF);
+    level_.push_back(0);
+    reason_.push_back(-1);
+    phase_.push_back(0);
+    activity_.push_back(0);
+    heap_pos_.push_back(-1);
+    seen_.push_back(0);
+    level_stamp_.push_back(0);
+    watches_.emplace_back();
+    watches_.emplace_back();
+    heap_insert(var);
+    return var;
+}
+
+// Метод для додавання клаузи
+bool sat_solver::add_clause(std::vector<int> lits) {
+    if (unsat_) return false;
+
+    // Клаузи додаються між пошуками, тобто на нульовому рівні: хибні літерали відкидаються, істинний робить клаузу зайвою
+    std::sort(lits.begin(), lits.end());
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < lits.size(); ++i) {
+        int lit = lits[i];
+        if (value(lit) == 1 || (i > 0 && lits[i - 1] == negate(lit))) return true;
+        if (value(lit) == 0 || (size > 0 && lits[size - 1] == lit)) continue;
+        lits[size++] = lit;
+    }
+    lits.resize(size);
+
+    if (lits.empty()) {
+        unsat_ = true;
+        return false;
+    }
+    if (lits.size() == 1) {
+        assign(lits[0], -1);
+        return true;
+    }
+    attach(std::move(lits), false);
+    return true;
+}
+
+// Метод для постановки клаузи під спостереження
+int sat_solver::attach(std::vector<int> lits, bool learnt) {
+    int index;
+    if (!free_clauses_.empty()) {
+        index = free_clauses_.back();
+        free_clauses_.pop_back();
+    } else {
+        index = static_cast<int>(clauses_.size());
+        clauses_.emplace_back();
+    }
+    clause &c = clauses_[index];
+    c.lits = std::move(lits);
+    c.learnt = learnt;
+    c.deleted = false;
+    c.lbd = 0;
+    c.activity = 0;
+    watches_[negate(c.lits[0])].push_back({ index, c.lits[1] });
+    watches_[negate(c.lits[1])].push_back({ index, c.lits[0] });
+    if (learnt) learnts_.push_back(index);
+    return index;
+}
+
+// Метод для присвоєння літерала
+void sat_solver::assign(int lit, int from) {
+    int var = var_of(lit);
+    assigns_[var] = static_cast<signed char>((lit & 1) ^ 1);
+    level_[var] = decision_level();
+    reason_[var] = from;
+    trail_.push_back(lit);
+}
+
+// Метод для поширення присвоєнь (два спостережувані літерали)
+int sat_solver::propagate() {
+    while (propagated_ < static_cast<int>(trail_.size())) {
+        int p = trail_[propagated_++];
+        int false_lit = negate(p);
+        std::vector<watcher> &ws = watches_[p];
+        std::size_t i = 0, j = 0, end = ws.size();
+        while (i < end) {
+            watcher w = ws[i++];
+            if (value(w.blocker) == 1) {
+                ws[j++] = w;
+                continue;
+            }
+
+            std::vector<int> &lits = clauses_[w.clause].lits;
+            if (lits[0] == false_lit) std::swap(lits[0], lits[1]);
+            int first = lits[0];
+            if (first != w.blocker && value(first) == 1) {
+                ws[j++] = { w.clause, first };
+                continue;
+            }
+
+            // Шукаємо новий літерал для спостереження замість хибного
+            bool moved = false;
+            for (std::size_t k = 2; k < lits.size(); ++k) {
+                if (value(lits[k]) != 0) {
+                    std::swap(lits[1], lits[k]);
+                    watches_[negate(lits[1])].push_back({ w.clause, first });
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            // Клауза одинична або хибна
+            ws[j++] = { w.clause, first };
+            if (value(first) == 0) {
+                while (i < end) ws[j++] = ws[i++];
+                ws.resize(j);
+                propagated_ = static_cast<int>(trail_.size());
+                return w.clause;
+            }
+            assign(first, w.clause);
+        }
+        ws.resize(j);
+    }
+    return -1;
+}
+
+// Метод для аналізу конфлікту (перша точка домінування)
+void sat_solver::analyze(int conflict, std::vector<int> &learnt, int &back_level) {
+    learnt.clear();
+    learnt.push_back(-1);
+    int pending = 0, p = -1;
+    int index = static_cast<int>(trail_.size()) - 1;
+
+    do {
+        clause &c = clauses_[conflict];
+        if (c.learnt) bump_clause(c);
+        for (std::size_t j = p < 0 ? 0 : 1; j < c.lits.size(); ++j) {
+            int q = c.lits[j];
+            int var = var_of(q);
+            if (seen_[var] || level_[var] == 0) continue;
+            bump_var(var);
+            seen_[var] = 1;
+            if (level_[var] >= decision_level()) ++pending;
+            else learnt.push_back(q);
+        }
+        // Наступний позначений літерал на сліді поточного рівня
+        while (!seen_[var_of(trail_[index--])]) {}
+        p = trail_[index + 1];
+        conflict = reason_[var_of(p)];
+        seen_[var_of(p)] = 0;
+        --pending;
+    } while (pending > 0);
+    learnt[0] = negate(p);
+
+    // Мінімізація: літерал зайвий, якщо його заперечення випливає з решти літералів клаузи
+    analyze_clear_.assign(learnt.begin(), learnt.end());
+    unsigned levels = 0;
+    for (std::size_t i = 1; i < learnt.size(); ++i) levels |= 1u << (level_[var_of(learnt[i])] & 31);
+    std::size_t size = 1;
+    for (std::size_t i = 1; i < learnt.size(); ++i) {
+        if (reason_[var_of(learnt[i])] < 0 || !redundant(learnt[i], levels)) learnt[size++] = learnt[i];
+    }
+    learnt.resize(size);
+    for (int lit : analyze_clear_) seen_[var_of(lit)] = 0;
+
+    // Другим ставимо літерал з найвищого рівня після поточного — туди й повертаємось
+    back_level = 0;
+    if (learnt.size() > 1) {
+        std::size_t max_i = 1;
+        for (std::size_t i = 2; i < learnt.size(); ++i)
+            if (level_[var_of(learnt[i])] > level_[var_of(learnt[max_i])]) max_i = i;
+        std::swap(learnt[1], learnt[max_i]);
+        back_level = level_[var_of(learnt[1])];
+    }
+}
+
+// Метод для рекурсивної перевірки зайвого літерала навченої клаузи
+bool sat_solver::redundant(int lit, unsigned levels) {
+    analyze_stack_.clear();
+    analyze_stack_.push_back(lit);
+    std::size_t top = analyze_clear_.size();
+    while (!analyze_stack_.empty()) {
+        int q = analyze_stack_.back();
+        analyze_stack_.pop_back();
+        const std::vector<int> &lits = clauses_[reason_[var_of(q)]].lits;
+        for (std::size_t i = 1; i < lits.size(); ++i) {
+            int var = var_of(lits[i]);
+            if (seen_[var] || level_[var] == 0) continue;
+            if (reason_[var] >= 0 && (levels >> (level_[var] & 31) & 1)) {
+                seen_[var] = 1;
+                analyze_stack_.push_back(lits[i]);
+                analyze_clear_.push_back(lits[i]);
+            } else {
+                for (std::size_t j = top; j < analyze_clear_.size(); ++j) seen_[var_of(analyze_clear_[j])] = 0;
+                analyze_clear_.resize(top);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Метод для повернення на рівень level
+void sat_solver::backtrack(int level) {
+    if (decision_level() <= level) return;
+    for (int i = static_cast<int>(trail_.size()) - 1; i >= trail_lim_[level]; --i) {
+        int var = var_of(trail_[i]);
+        phase_[var] = assigns_[var];
+        assigns_[var] = UNDEF;
+        reason_[var] = -1;
+        if (heap_pos_[var] < 0) heap_insert(var);
+    }
+    trail_.resize(trail_lim_[level]);
+    trail_lim_.resize(level);
+    propagated_ = static_cast<int>(trail_.size());
+}
+
+// Метод для вибору змінної рішення
+int sat_solver::pick_branch() {
+    while (!heap_.empty()) {
+        int var = heap_pop();
+        if (assigns_[var] == UNDEF) return phase_[var] == 1 ? positive(var) : negative(var);
+    }
+    return -1;
+}
+
+// Метод для видалення навчених клауз
+void sat_solver::reduce_learnts() {
+    // Спершу найгірші: більший LBD, потім менша активність
+    std::sort(learnts_.begin(), learnts_.end(), [&](int a, int b) {
+        const clause &x = clauses_[a], &y = clauses_[b];
+        if (x.lbd != y.lbd) return x.lbd > y.lbd;
+        return x.activity < y.activity;
+    });
+
+    std::size_t remove = learnts_.size() / 2, kept = 0;
+    bool removed_any = false;
+    for (std::size_t i = 0; i < learnts_.size(); ++i) {
+        clause &c = clauses_[learnts_[i]];
+        int first = var_of(c.lits[0]);
+        bool locked = reason_[first] == learnts_[i] && value(c.lits[0]) == 1;
+        if (i < remove && c.lbd > 2 && !locked) {
+            c.deleted = true;
+            removed_any = true;
+        } else {
+            learnts_[kept++] = learnts_[i];
+        }
+    }
+    learnts_.resize(kept);
+    if (!removed_any) return;
+
+    // Видалені клаузи прибираються зі списків спостереження одразу, тож їхні номери можна використати знову
+    for (std::vector<watcher> &ws : watches_) {
+        ws.erase(std::remove_if(ws.begin(), ws.end(), [&](const watcher &w) { return clauses_[w.clause].deleted; }),
+                 ws.end());
+    }
+    for (int i = 0; i < static_cast<int>(clauses_.size()); ++i) {
+        clause &c = clauses_[i];
+        if (!c.deleted || c.lits.empty()) continue;
+        std::vector<int>().swap(c.lits);
+        free_clauses_.push_back(i);
+    }
+}
+
+// Метод для пошуку виконуючого набору
+sat_solver::result sat_solver::solve(const stop_check &stop) {
+    if (unsat_) return result::UNSATISFIABLE;
+    if (propagate() >= 0) {
+        unsat_ = true;
+        return result::UNSATISFIABLE;
+    }
+
+    std::vector<int> learnt;
+    long long restart = 0, restart_conflicts = 0, restart_limit = 100 * luby(0);
+    while (true) {
+        int conflict = propagate();
+        if (conflict >= 0) {
+            ++conflicts_;
+            ++restart_conflicts;
+            if (decision_level() == 0) {
+                unsat_ = true;
+                return result::UNSATISFIABLE;
+            }
+
+            int back_level;
+            analyze(conflict, learnt, back_level);
+            backtrack(back_level);
+            if (learnt.size() == 1) {
+                assign(learnt[0], -1);
+            } else {
+                // LBD — кількість різних рівнів серед літералів клаузи
+                ++stamp_;
+                int lbd = 0;
+                for (int lit : learnt) {
+                    int level = level_[var_of(lit)];
+                    if (level_stamp_[level] != stamp_) {
+                        level_stamp_[level] = stamp_;
+                        ++lbd;
+                    }
+                }
+                int index = attach(learnt, true);
+                clauses_[index].lbd = lbd;
+                bump_clause(clauses_[index]);
+                assign(learnt[0], index);
+            }
+            var_inc_ /= 0.95;
+            clause_inc_ /= 0.999;
+
+            if (stop && stop()) {
+                backtrack(0);
+                return result::INTERRUPTED;
+            }
+            continue;
+        }
+
+        if (restart_conflicts >= restart_limit) {
+            backtrack(0);
+            restart_conflicts = 0;
+            restart_limit = 100 * luby(++restart);
+        }
+        if (conflicts_ >= next_reduce_) {
+            reduce_learnts();
+            next_reduce_ = conflicts_ + 2000 + static_cast<long long>(learnts_.size());
+        }
+
+        int lit = pick_branch();
+        if (lit < 0) {
+            model_.assign(assigns_.begin(), assigns_.end());
+            backtrack(0);
+            return result::SATISFIABLE;
+        }
+        ++decisions_;
+        trail_lim_.push_back(static_cast<int>(trail_.size()));
+        assign(lit, -1);
+    }
+}
+
+// Методи для збільшення активності
+void sat_solver::bump_var(int var) {
+    if ((activity_[var] += var_inc_) > 1e100) {
+        for (double &a : activity_) a *= 1e-100;
+        var_inc_ *= 1e-100;
+    }
+    if (heap_pos_[var] >= 0) heap_up(heap_pos_[var]);
+}
+
+void sat_solver::bump_clause(clause &c) {
+    if ((c.activity += clause_inc_) > 1e20) {
+        for (int index : learnts_) clauses_[index].activity *= 1e-20;
+        clause_inc_ *= 1e-20;
+    }
+}
+
+// Методи купи змінних за спаданням активності
+void sat_solver::heap_insert(int var) {
+    heap_pos_[var] = static_cast<int>(heap_.size());
+    heap_.push_back(var);
+    heap_up(heap_pos_[var]);
+}
+
+void sat_solver::heap_up(int pos) {
+    int var = heap_[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (activity_[heap_[parent]] >= activity_[var]) break;
+        heap_[pos] = heap_[parent];
+        heap_pos_[heap_[pos]] = pos;
+        pos = parent;
+    }
+    heap_[pos] = var;
+    heap_pos_[var] = pos;
+}
+
+void sat_solver::heap_down(int pos) {
+    int var = heap_[pos];
+    int size = static_cast<int>(heap_.size());
+    while (true) {
+        int child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && activity_[heap_[child + 1]] > activity_[heap_[child]]) ++child;
+        if (activity_[heap_[child]] <= activity_[var]) break;
+        heap_[pos] = heap_[child];
+        heap_pos_[heap_[pos]] = pos;
+        pos = child;
+    }
+    heap_[pos] = var;
+    heap_pos_[var] = pos;
+}
+
+int sat_solver::heap_pop() {
+    int top = heap_[0];
+    heap_pos_[top] = -1;
+    int last = heap_.back();
+    heap_.pop_back();
+    if (!heap_.empty()) {
+        heap_[0] = last;
+        heap_pos_[last] = 0;
+        heap_down(0);
+    }
+    return top;
+}
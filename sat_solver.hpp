@@ -0,0 +1,138 @@
+// sat_solver.hpp
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/*
+    Невеликий CDCL-розв'язувач задачі виконуваності (SAT) без зовнішніх залежностей.
+    Змінні нумеруються від 0, літерал змінної v — 2v (істинна) або 2v + 1 (заперечення).
+    Усередині: два спостережувані літерали на клаузу, навчання клауз за першою точкою домінування (1UIP)
+    з мінімізацією, вибір змінної за активністю (VSIDS) із збереженням фази, перезапуски за послідовністю Лубі
+    і періодичне видалення навчених клауз з великою кількістю рівнів (LBD).
+    Розв'язувач інкрементальний: після solve можна додати клаузи і викликати solve знову, навчене зберігається
+*/
+class sat_solver {
+public:
+    enum class result { SATISFIABLE, UNSATISFIABLE, INTERRUPTED };
+
+    // Перевірка, чи треба перервати пошук; викликається після кожного конфлікту
+    using stop_check = std::function<bool()>;
+
+    static int positive(int var) { return 2 * var; }
+    static int negative(int var) { return 2 * var + 1; }
+    static int negate(int lit) { return lit ^ 1; }
+    static int var_of(int lit) { return lit >> 1; }
+
+    // Створює нову змінну і повертає її номер
+    int new_var();
+
+    int var_count() const { return static_cast<int>(assigns_.size()); }
+
+    /*
+        Додає клаузу (диз'юнкцію літералів). Повторені літерали прибираються, тавтологія не додається.
+        Повертає false, якщо формула вже точно невиконувана
+    */
+    bool add_clause(std::vector<int> lits);
+
+    // Шукає виконуючий набір; stop може бути порожнім
+    result solve(const stop_check &stop = stop_check());
+
+    // Значення змінної в останньому знайденому наборі
+    bool model_value(int var) const { return model_[var] != 0; }
+
+    // Лічильники за весь час життя розв'язувача
+    long long conflicts() const { return conflicts_; }
+    long long decisions() const { return decisions_; }
+
+private:
+    // Значення змінної: 0 — хиба, 1 — істина, 2 — не визначена
+    static constexpr signed char UNDEF = 2;
+
+    struct clause {
+        std::vector<int> lits;   // lits[0] і lits[1] — спостережувані літерали
+        bool learnt = false;
+        bool deleted = false;
+        int lbd = 0;             // кількість різних рівнів рішень у навченій клаузі
+        double activity = 0;
+    };
+
+    // Клауза в списку спостереження літерала разом з літералом-охоронцем: якщо він істинний, клаузу не відкриваємо
+    struct watcher {
+        int clause;
+        int blocker;
+    };
+
+    std::vector<clause> clauses_;
+    std::vector<int> free_clauses_;             // номери видалених клауз для повторного використання
+    std::vector<int> learnts_;                  // номери навчених клауз
+    std::vector<std::vector<watcher>> watches_; // клаузи, що спостерігають заперечення літерала (індекс — літерал)
+
+    std::vector<signed char> assigns_;          // значення змінних
+    std::vector<int> level_;                    // рівень рішення, на якому змінну присвоєно
+    std::vector<int> reason_;                   // клауза, що вивела значення, або -1 (рішення)
+    std::vector<signed char> phase_;            // останнє значення змінної (збереження фази)
+    std::vector<int> trail_;                    // присвоєні літерали в порядку присвоєння
+    std::vector<int> trail_lim_;                // початок кожного рівня рішень у trail_
+    int propagated_ = 0;                        // скільки літералів trail_ вже поширено
+
+    std::vector<double> activity_;              // активність змінних (VSIDS)
+    double var_inc_ = 1;
+    double clause_inc_ = 1;
+    std::vector<int> heap_;                     // купа змінних за активністю
+    std::vector<int> heap_pos_;                 // позиція змінної в купі або -1
+
+    std::vector<char> seen_;                    // позначки змінних під час аналізу конфлікту
+    std::vector<int> analyze_stack_;
+    std::vector<int> analyze_clear_;
+    std::vector<unsigned> level_stamp_;         // мітки рівнів для підрахунку LBD
+    unsigned stamp_ = 0;
+
+    std::vector<signed char> model_;
+    bool unsat_ = false;                        // порожня клауза виведена на нульовому рівні
+    long long conflicts_ = 0;
+    long long decisions_ = 0;
+    long long next_reduce_ = 2000;              // після скількох конфліктів наступне видалення навчених клауз
+
+    int decision_level() const { return static_cast<int>(trail_lim_.size()); }
+
+    signed char value(int lit) const {
+        signed char v = assigns_[var_of(lit)];
+        return v == UNDEF ? UNDEF : static_cast<signed char>(v ^ (lit & 1));
+    }
+
+    // Присвоює літерал істинним з причиною from
+    void assign(int lit, int from);
+
+    // Поширює присвоєння; повертає клаузу-конфлікт або -1
+    int propagate();
+
+    // Аналіз конфлікту: навчена клауза (перший літерал — твердження) і рівень повернення
+    void analyze(int conflict, std::vector<int> &learnt, int &back_level);
+
+    // Чи випливає заперечення літерала з інших літералів навченої клаузи (рекурсивна мінімізація)
+    bool redundant(int lit, unsigned levels);
+
+    // Скасовує присвоєння вище рівня level
+    void backtrack(int level);
+
+    // Наступний літерал рішення або -1, якщо всі змінні присвоєні
+    int pick_branch();
+
+    // Додає клаузу до бази і ставить її під спостереження; повертає номер
+    int attach(std::vector<int> lits, bool learnt);
+
+    // Видаляє половину навчених клауз з найгіршими LBD і активністю
+    void reduce_learnts();
+
+    // Збільшення активності змінної і клаузи
+    void bump_var(int var);
+    void bump_clause(clause &c);
+
+    // Операції купи змінних
+    void heap_insert(int var);
+    void heap_up(int pos);
+    void heap_down(int pos);
+    int heap_pop();
+};
@@ -0,0 +1,69 @@
+// solver_stats.cpp
+#include "solver_stats.hpp"
+#include <algorithm>
+#include <iomanip>
+
+// Метод для додавання статистики іншого потоку
+void solver_stats::merge(const solver_stats &other) {
+    nodes += other.nodes;
+    regions += other.regions;
+    max_depth = std::max(max_depth, other.max_depth);
+    prune_2x2 += other.prune_2x2;
+    prune_connectivity += other.prune_connectivity;
+    prune_propagation += other.prune_propagation;
+    prune_no_candidates += other.prune_no_candidates;
+    failed_leaves += other.failed_leaves;
+    time_select += other.time_select;
+    time_enumerate += other.time_enumerate;
+    time_connectivity += other.time_connectivity;
+    time_propagate += other.time_propagate;
+
+    if (clues.size() < other.clues.size()) clues.resize(other.clues.size());
+    for (size_t i = 0; i < other.clues.size(); ++i) {
+        clues[i].row = other.clues[i].row;
+        clues[i].col = other.clues[i].col;
+        clues[i].value = other.clues[i].value;
+        clues[i].regions += other.clues[i].regions;
+    }
+}
+
+// Метод для виводу статистики
+void solver_stats::print(std::ostream &out) const {
+    auto ms = [](double seconds) { return seconds * 1000.0; };
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << "--- Статистика пошуку ---\n"
+        << "Вузли пошуку:               " << nodes << "\n"
+        << "Згенеровані області:        " << regions << "\n"
+        << "Найбільша глибина:          " << max_depth << "\n"
+        << "Відсічення:\n"
+        << "  квадрат 2x2:              " << prune_2x2 << "\n"
+        << "  зв'язність:               " << prune_connectivity << "\n"
+        << "  логічні висновки:         " << prune_propagation << "\n"
+        << "  немає варіантів області:  " << prune_no_candidates << "\n"
+        << "  невдалий кінцевий стан:   " << failed_leaves << "\n"
+        << std::fixed << std::setprecision(3)
+        << "Час, мс:\n"
+        << "  вибір числа:              " << ms(time_select) << "\n"
+        << "  перебір областей:         " << ms(time_enumerate) << "\n"
+        << "  зв'язність:               " << ms(time_connectivity) << "\n"
+        << "  логічні висновки:         " << ms(time_propagate) << "\n"
+        << "  загалом:                  " << ms(time_total) << "\n";
+
+    // Числа, для яких генерувалося найбільше варіантів, — саме вони роблять задачу важкою
+    std::vector<clue_stat> busy;
+    for (const clue_stat &c : clues)
+        if (c.regions > 0) busy.push_back(c);
+    std::sort(busy.begin(), busy.end(), [](const clue_stat &a, const clue_stat &b) {
+        return a.regions > b.regions;
+    });
+    if (busy.size() > 10) busy.resize(10);
+    if (!busy.empty()) {
+        out << "Числа з найбільшою кількістю областей (рядок, стовпець, число: області):\n";
+        for (const clue_stat &c : busy)
+            out << "  (" << c.row + 1 << ", " << c.col + 1 << ") " << c.value << ": " << c.regions << "\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,71 @@
+// solver_stats.hpp
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+/*
+    Статистика пошуку nurikabe_solver. Вмикається через nurikabe_solver::set_stats:
+    поки вказівник не задано, розв'язувач лише перевіряє його на nullptr і нічого не рахує.
+    Лічильники додаються до вже накопичених, тож для окремого розв'язання варто викликати reset()
+*/
+struct solver_stats {
+    // Статистика одного числа
+    struct clue_stat {
+        int row = 0;
+        int col = 0;
+        int value = 0;
+        long long regions = 0;      // кількість згенерованих для нього варіантів області у вузлах пошуку
+    };
+
+    long long nodes = 0;            // вузли пошуку (виклики solve_recurse, що дійшли до розгалуження)
+    long long regions = 0;          // згенеровані варіанти областей у всіх вузлах
+    int max_depth = 0;              // найбільша кількість зафіксованих областей на шляху від кореня
+
+    // Відсічення гілок за причиною
+    long long prune_2x2 = 0;           // нова область замкнула чорний квадрат 2x2
+    long long prune_connectivity = 0;  // нова область розірвала чорну область
+    long long prune_propagation = 0;   // логічні висновки дійшли до суперечності
+    long long prune_no_candidates = 0; // у якогось числа не лишилося жодного варіанту області
+    long long failed_leaves = 0;       // усі числа розставлено, але фінальна перевірка не пройшла
+
+    // Час у примітивах, секунди (вкладені виклики враховуються і в зовнішньому примітиві)
+    double time_select = 0;         // вибір числа для розгалуження (підрахунок варіантів)
+    double time_enumerate = 0;      // побудова списку варіантів області вибраного числа
+    double time_connectivity = 0;   // перевірки зв'язності чорної області
+    double time_propagate = 0;      // логічні висновки
+    double time_total = 0;          // увесь solve / solve_parallel
+
+    std::vector<clue_stat> clues;   // статистика за числами в порядку рядків
+
+    // Обнуляє всі лічильники
+    void reset() { *this = solver_stats(); }
+
+    // Додає лічильники іншого потоку (числа збігаються, бо потоки розв'язують ту саму сітку)
+    void merge(const solver_stats &other);
+
+    // Виводить статистику у читабельному вигляді
+    void print(std::ostream &out) const;
+};
+
+// Вимірювач часу одного виклику примітиву: без статистики не звертається до годинника
+class stat_timer {
+public:
+    stat_timer(solver_stats *stats, double solver_stats::*field) : stats_(stats), field_(field) {
+        if (stats_) start_ = std::chrono::steady_clock::now();
+    }
+    ~stat_timer() {
+        if (stats_) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+            stats_->*field_ += elapsed.count();
+        }
+    }
+    stat_timer(const stat_timer &) = delete;
+    stat_timer &operator=(const stat_timer &) = delete;
+
+private:
+    solver_stats *stats_;
+    double solver_stats::*field_;
+    std::chrono::steady_clock::time_point start_;
+};
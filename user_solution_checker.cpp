@@ -1,13 +1,17 @@
 // user_solution_checker.cpp
 #include "user_solution_checker.hpp"
+#include "grid_reader.hpp"
 #include <limits>
-#include <queue>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 
-user_solution_checker::user_solution_checker(const std::vector<std::vector<int>>& initialGrid) : initial_(initialGrid),
-    rows_(static_cast<int>(initialGrid.size())),
-    cols_(rows_ ? static_cast<int>(initialGrid[0].size()) : 0),
-    user_grid_(rows_, std::vector<int>(cols_, 0))
+user_solution_checker::user_solution_checker(const flat_grid& initialGrid) : initial_(initialGrid),
+    rows_(initialGrid.rows()),
+    cols_(initialGrid.cols()),
+    user_grid_(rows_, cols_)
 {}
 
 // Метод для перевірки правильності вводу і коректності користувацького рішеня
@@ -54,16 +58,16 @@ bool user_solution_checker::input_phase(std::istream& in, std::ostream& out) {
                     Якщо користувач ввів число більше нуля (клітинка з підказкою), перевіряєм чи є вона на цьому місці
                     в початковій сітці і чи значення збігаються
                 */
-                if (v > 0 && initial_[r][c] == 0) {
+                if (v > 0 && initial_.at(r, c) == 0) {
                     out << "Помилка: у клітинці ("<< r+1 << "," << c+1
                         <<") не було підказки, а ви ввели " << v << ".\n";
                     format_error = true;
                     break;
                 }
                 // Якщо користувач не ввів підказку, яка була на цьому місці - виводимо відповідну помилку
-                if (initial_[r][c] > 0 && initial_[r][c] != v) {
+                if (initial_.at(r, c) > 0 && initial_.at(r, c) != v) {
                     out << "Помилка: у клітинці ("<< r+1 << "," << c+1
-                        <<") очікувалась підказка " << initial_[r][c]
+                        <<") очікувалась підказка " << initial_.at(r, c)
                         << ", а ви ввели " << v << ".\n";
                     format_error = true;
                     break;
@@ -74,7 +78,7 @@ bool user_solution_checker::input_phase(std::istream& in, std::ostream& out) {
                 in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
             } else {
                 // Якщо рядок коректний - записуєм його користвацьку сітку для майбутньої перевірки
-                user_grid_[r] = std::move(row_vals);
+                for (int c = 0; c < cols_; ++c) user_grid_.at(r, c) = row_vals[c];
                 break;
             }
         }
@@ -83,28 +87,9 @@ bool user_solution_checker::input_phase(std::istream& in, std::ostream& out) {
 }
 
 bool user_solution_checker::validation_phase(std::ostream& out) {
-    // Координати верхнього лівого кута чорного блока 2x2, якщо він буде
-    cell lt;
-    if (check_black_2x2_block(lt)) {
-        // Якщо чорний блок було знайдено, виводим помилку і координати лівого верхнього кута
-        out << "\nПомилка: знайдено 2×2 чорний блок у клітині ("
-            << lt.row+1 << "," << lt.col+1 << ")\n";
-        return false;
-    }
-    // Перевірка чорної області на зв'язність
-    if (!check_black_connectivity()) {
-        out << "\nПомилка: чорна область незв'язна\n";
-        return false;
-    }
-    // Причина помилки
-    std::string reason;
-    // Клітинка де знайдена помилка
-    cell loc;
-    if (!check_islands(reason, loc)) {
-        out << "\nПомилка: " << reason;
-        if (loc.row >= 0)
-            out << " (рядок " << loc.row+1 << ", стовпець " << loc.col+1 << ")";
-        out << "\n";
+    solution_verdict verdict = validate(initial_, user_grid_);
+    if (!verdict.ok()) {
+        out << "\nПомилка: " << verdict.message() << "\n";
         return false;
     }
 
@@ -112,112 +97,405 @@ bool user_solution_checker::validation_phase(std::ostream& out) {
     return true;
 }
 
-// Метод для перевірки наявності чорних блоків 2x2 і повернення лівої верхньої клітинки проблемного блоку
-bool user_solution_checker::check_black_2x2_block(cell &lt) const {
-    for (int r = 0; r+1 < rows_; ++r) {
-        for (int c = 0; c+1 < cols_; ++c) {
-            if (user_grid_[r][c]==-1 &&
-                user_grid_[r+1][c]==-1 &&
-                user_grid_[r][c+1]==-1 &&
-                user_grid_[r+1][c+1]==-1)
-            {
-                lt.row = r; lt.col = c;
-                return true;
-            }
+// Метод для опису помилки
+std::string solution_verdict::message() const {
+    std::string where = " (рядок " + std::to_string(at.row + 1) + ", стовпець " + std::to_string(at.col + 1) + ")";
+    switch (error) {
+    case kind::OK:
+        return "рішення правильне";
+    case kind::SIZE_MISMATCH:
+        return "розміри рішення не збігаються з розмірами задачі";
+    case kind::BAD_VALUE:
+        return "недопустиме значення " + std::to_string(actual) + where;
+    case kind::CLUE_MISMATCH:
+        if (expected == 0) return "у клітинці не було підказки, а в рішенні " + std::to_string(actual) + where;
+        return "очікувалась підказка " + std::to_string(expected) + ", а в рішенні " + std::to_string(actual) + where;
+    case kind::BLACK_2X2:
+        return "знайдено 2×2 чорний блок у клітині (" + std::to_string(at.row + 1) + "," + std::to_string(at.col + 1) + ")";
+    case kind::BLACK_DISCONNECTED:
+        return "чорна область незв'язна" + where;
+    case kind::ISLAND_MANY_CLUES:
+        return "острів має більше 1 підказки" + where;
+    case kind::ISLAND_NO_CLUE:
+        return "острів не має підказки" + where;
+    case kind::ISLAND_SIZE:
+        return "площа острова (" + std::to_string(actual) + ") не дорівнює значенню підказки: " + std::to_string(expected) + where;
+    }
+    return "";
+}
+
+// Менший із двох індексів, де -1 означає відсутність
+template <class T>
+static T first_of(T a, T b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+    return std::min(a, b);
+}
+
+/*
+    Розмітка компонент системою неперетинних множин. Корінь компоненти — її найменший індекс,
+    тобто перша клітинка в порядку обходу рядків. Робочі масиви перевикористовуються між перевірками одного потоку
+*/
+struct component_labelling {
+    struct node {
+        int parent;
+        int size;         // площа компоненти (дійсна для кореня)
+        int clue;         // індекс першої підказки компоненти або -1
+        int extra_clue;   // індекс другої підказки компоненти або -1
+    };
+    std::vector<node> nodes;
+
+    int find(int id) {
+        while (nodes[id].parent != id) {
+            nodes[id].parent = nodes[nodes[id].parent].parent;
+            id = nodes[id].parent;
         }
+        return id;
     }
-    return false;
+
+    void unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (b < a) std::swap(a, b);
+        node &root = nodes[a], &other = nodes[b];
+        other.parent = a;
+        root.size += other.size;
+
+        // Друга підказка об'єднаної компоненти — найменша з усіх, крім першої
+        int second = root.clue >= 0 && other.clue >= 0 ? std::max(root.clue, other.clue) : -1;
+        root.extra_clue = first_of(first_of(root.extra_clue, other.extra_clue), second);
+        root.clue = first_of(root.clue, other.clue);
+    }
+};
+
+// Колір клітинки рішення: 1 — чорна, 2 — біла (заповнена або підказка), 0 — недопустиме значення
+static int colour_of(int v) {
+    if (v == -1) return 1;
+    if (v == -2 || v > 0) return 2;
+    return 0;
 }
 
-// Метод для перевірки зв'язності чорної області
-bool user_solution_checker::check_black_connectivity() const {
-    std::vector<char> vis(rows_ * cols_, 0);
-    cell start(-1, -1);
-    int total_black = 0;
-    for (int r = 0; r < rows_; ++r)
-        for (int c = 0; c < cols_; ++c)
-            if (user_grid_[r][c] == -1) {
-                if (start.row < 0) start = cell(r, c);
-                ++total_black;
+// Перевірка рішення з наданими робочими масивами
+static solution_verdict validate_with(const flat_grid &initial, const flat_grid &solution, component_labelling &lab) {
+    solution_verdict verdict;
+    if (initial.rows() != solution.rows() || initial.cols() != solution.cols()) {
+        verdict.error = solution_verdict::kind::SIZE_MISMATCH;
+        return verdict;
+    }
+
+    int rows = solution.rows(), cols = solution.cols(), stride = solution.stride();
+    lab.nodes.resize(solution.size());
+
+    /*
+        Один прохід по рядках: перевірка значень і підказок, пошук чорного блока 2x2 за нижнім правим кутом
+        і об'єднання клітинки з верхнім та лівим сусідом того самого кольору.
+        Помилки значень мають пріоритет (їх виявляє ще фаза зчитування), тож блок 2x2 лише запам'ятовується
+    */
+    int block_2x2 = -1;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int id = solution.index(r, c);
+            int v = solution[id], clue = initial.at(r, c);
+            int colour = colour_of(v);
+            if (colour == 0) {
+                verdict.error = solution_verdict::kind::BAD_VALUE;
+                verdict.at = cell(r, c);
+                verdict.actual = v;
+                return verdict;
             }
-    if (start.row < 0) return true;
-    std::queue<cell> q;
-    q.push(start);
-    vis[start.row * cols_ + start.col] = 1;
-    int count = 0;
-    while (!q.empty()) {
-        cell u = q.front(); q.pop();
-        ++count;
-        for (int d = 0; d < 4; ++d) {
-            int nr = u.row + DR_[d], nc = u.col + DC_[d];
-            int nid = nr * cols_ + nc;
-            if (out_of_bounds(nr, nc) || vis[nid] || user_grid_[nr][nc] != -1)
-                continue;
-            vis[nid] = 1;
-            q.push(cell(nr, nc));
+            if ((v > 0 || clue > 0) && v != clue) {
+                verdict.error = solution_verdict::kind::CLUE_MISMATCH;
+                verdict.at = cell(r, c);
+                verdict.expected = clue;
+                verdict.actual = v;
+                return verdict;
+            }
+
+            lab.nodes[id] = { id, 1, v > 0 ? id : -1, -1 };
+            int up = id - stride, left = id - 1;
+            // Клітинки рамки мають колір 0 і ні з чим не об'єднуються
+            if (colour_of(solution[up]) == colour) lab.unite(up, id);
+            if (colour_of(solution[left]) == colour) lab.unite(left, id);
+            if (colour == 1 && block_2x2 < 0 && solution[up] == -1 && solution[left] == -1 && solution[up - 1] == -1)
+                block_2x2 = up - 1;
         }
     }
-    return count == total_black;
-}
 
-// Метод для перевірки площі островів
-bool user_solution_checker::check_islands(std::string &reason, cell &loc) const {
-    // Список для зберігання пройдених клітинок
-    std::vector<char> vis(rows_ * cols_, 0);
+    if (block_2x2 >= 0) {
+        verdict.error = solution_verdict::kind::BLACK_2X2;
+        verdict.at = cell(solution.row_of(block_2x2), solution.col_of(block_2x2));
+        return verdict;
+    }
 
-    for (int r = 0; r < rows_; ++r) {
-        for (int c = 0; c < cols_; ++c) {
-            // Якщо клітинка не пройдена і належить білій області - перевіряємо її
-            if (!vis[r * cols_ + c] && (user_grid_[r][c] > 0 || user_grid_[r][c] == -2)) {
-                // Черга для проходу в ширину по білій області
-                std::queue<cell> q;
-                cell start(-1, -1);
-                // Змінна для підрахунку розміру білої області
-                int size = 0;
-                // Додаємо в чергу стартову клітинку і помічаємо її як пройдену
-                q.push(cell(r, c));
-                vis[r * cols_ + c] = 1;
-
-                // Проходимося по всім клітинкам і рахуємо розмір області, також паралельно записуємо клітинку з числом в start
-                while (!q.empty()) {
-                    cell u = q.front(); q.pop();
-                    size++;
-                    if (user_grid_[u.row][u.col] > 0) {
-                        if (start.row == -1) {
-                            start = u;
-                        } else {
-                            reason = "острів має більше 1 підказки";
-                            loc = u;
-                            return false;
-                        }
-                    }
-                    for (int d = 0; d < 4; ++d) {
-                        int nr = u.row + DR_[d], nc = u.col + DC_[d];
-                        int nid = nr * cols_ + nc;
-                        if (out_of_bounds(nr, nc) || vis[nid]) continue;
-                        if (user_grid_[nr][nc] > 0 || user_grid_[nr][nc] == -2) {
-                            vis[nid] = 1;
-                            q.push(cell(nr, nc));
-                        }
-                    }
-                }
+    // Обхід коренів: друга чорна компонента важливіша за помилки островів, тож перша з них лише запам'ятовується
+    bool black_seen = false;
+    solution_verdict island;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int id = solution.index(r, c);
+            const component_labelling::node &n = lab.nodes[id];
+            if (n.parent != id) continue;
 
-                // Якщо в області немає клітинки з підказкою - повертаємо false
-                if (start.row == -1) {
-                    reason = "острів не має підказки";
-                    loc = cell(r, c);
-                    return false;
+            if (solution[id] == -1) {
+                if (black_seen) {
+                    verdict.error = solution_verdict::kind::BLACK_DISCONNECTED;
+                    verdict.at = cell(r, c);
+                    return verdict;
                 }
+                black_seen = true;
+                continue;
+            }
+            if (!island.ok()) continue;
 
-                // Якщо площа області не збігається з сумою клітинок з підказками - повертаємо false
-                int area = user_grid_[start.row][start.col];
-                if (area != size) {
-                    reason = "площа острова (" + std::to_string(size) + ") не дорівнює значенню підказки: " + std::to_string(area);
-                    loc = start;
-                    return false;
-                }
+            if (n.extra_clue >= 0) {
+                island.error = solution_verdict::kind::ISLAND_MANY_CLUES;
+                island.at = cell(solution.row_of(n.extra_clue), solution.col_of(n.extra_clue));
+            } else if (n.clue < 0) {
+                island.error = solution_verdict::kind::ISLAND_NO_CLUE;
+                island.at = cell(r, c);
+            } else if (solution[n.clue] != n.size) {
+                island.error = solution_verdict::kind::ISLAND_SIZE;
+                island.at = cell(solution.row_of(n.clue), solution.col_of(n.clue));
+                island.expected = solution[n.clue];
+                island.actual = n.size;
             }
         }
     }
-    return true;
+    return island;
+}
+
+// Метод для перевірки готового рішення
+solution_verdict user_solution_checker::validate(const flat_grid &initial, const flat_grid &solution) {
+    component_labelling lab;
+    return validate_with(initial, solution, lab);
+}
+
+// Метод для паралельної перевірки багатьох рішень
+std::vector<solution_verdict> user_solution_checker::validate_batch(const std::vector<flat_grid> &initials,
+                                                                    const std::vector<flat_grid> &solutions,
+                                                                    unsigned threads) {
+    std::vector<solution_verdict> verdicts(solutions.size());
+    if (solutions.empty()) return verdicts;
+    if (initials.size() != 1 && initials.size() != solutions.size())
+        throw std::runtime_error("Кількість задач не відповідає кількості рішень");
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, solutions.size()));
+
+    // Потоки беруть рішення блоками, щоб не змагатися за лічильник на кожній дрібній сітці
+    const std::size_t BLOCK = 64;
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        component_labelling lab;
+        while (true) {
+            std::size_t begin = next.fetch_add(BLOCK);
+            if (begin >= solutions.size()) return;
+            std::size_t end = std::min(begin + BLOCK, solutions.size());
+            for (std::size_t i = begin; i < end; ++i)
+                verdicts[i] = validate_with(initials.size() == 1 ? initials[0] : initials[i], solutions[i], lab);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread &thread : pool) thread.join();
+    return verdicts;
+}
+
+streaming_solution_checker::streaming_solution_checker(int cols) : cols_(cols),
+    nodes_(2 * static_cast<std::size_t>(cols)),
+    compact_(2 * static_cast<std::size_t>(cols)),
+    prev_label_(cols),
+    prev_colour_(cols),
+    cur_colour_(cols),
+    remap_(2 * static_cast<std::size_t>(cols))
+{}
+
+int streaming_solution_checker::find(int id) {
+    while (nodes_[id].parent != id) {
+        nodes_[id].parent = nodes_[nodes_[id].parent].parent;
+        id = nodes_[id].parent;
+    }
+    return id;
+}
+
+void streaming_solution_checker::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    if (b < a) std::swap(a, b);
+    node &root = nodes_[a], &other = nodes_[b];
+    other.parent = a;
+    root.size += other.size;
+    root.first = std::min(root.first, other.first);
+
+    // Друга підказка об'єднаної компоненти — найраніша з усіх, крім першої
+    long long second = root.clue >= 0 && other.clue >= 0 ? std::max(root.clue, other.clue) : -1;
+    root.extra_clue = first_of(first_of(root.extra_clue, other.extra_clue), second);
+    if (other.clue >= 0 && (root.clue < 0 || other.clue < root.clue)) {
+        root.clue = other.clue;
+        root.clue_value = other.clue_value;
+    }
+}
+
+// Метод для перевірки завершеної компоненти
+void streaming_solution_checker::close(const node &n) {
+    // Для вердикту, як і в validate, важлива друга за порядком чорна компонента
+    if (n.colour == 1) {
+        if (black_first_ < 0 || n.first < black_first_) {
+            black_second_ = black_first_;
+            black_first_ = n.first;
+        } else if (black_second_ < 0 || n.first < black_second_) {
+            black_second_ = n.first;
+        }
+        return;
+    }
+
+    // Серед хибних островів важливий найраніший
+    if (island_first_ >= 0 && n.first > island_first_) return;
+    solution_verdict verdict;
+    if (n.extra_clue >= 0) {
+        verdict.error = solution_verdict::kind::ISLAND_MANY_CLUES;
+        verdict.at = to_cell(n.extra_clue);
+    } else if (n.clue < 0) {
+        verdict.error = solution_verdict::kind::ISLAND_NO_CLUE;
+        verdict.at = to_cell(n.first);
+    } else if (n.clue_value != n.size) {
+        verdict.error = solution_verdict::kind::ISLAND_SIZE;
+        verdict.at = to_cell(n.clue);
+        verdict.expected = n.clue_value;
+        verdict.actual = static_cast<int>(n.size);
+    }
+    if (!verdict.ok()) {
+        island_error_ = verdict;
+        island_first_ = n.first;
+    }
+}
+
+// Метод для додавання рядка
+void streaming_solution_checker::push_row(const int *clues, const int *row) {
+    if (decided()) return;
+
+    long long base = rows_ * cols_;
+    for (int c = 0; c < cols_; ++c) {
+        int v = row[c], clue = clues[c];
+        long long pos = base + c;
+        int colour = colour_of(v);
+        if (colour == 0) {
+            value_error_.error = solution_verdict::kind::BAD_VALUE;
+            value_error_.at = to_cell(pos);
+            value_error_.actual = v;
+            return;
+        }
+        if ((v > 0 || clue > 0) && v != clue) {
+            value_error_.error = solution_verdict::kind::CLUE_MISMATCH;
+            value_error_.at = to_cell(pos);
+            value_error_.expected = clue;
+            value_error_.actual = v;
+            return;
+        }
+
+        int label = cols_ + c;
+        nodes_[label] = { label, colour, 1, pos, v > 0 ? pos : -1, -1, v > 0 ? v : 0 };
+        cur_colour_[c] = colour;
+        if (rows_ > 0 && prev_colour_[c] == colour) unite(prev_label_[c], label);
+        if (c > 0 && cur_colour_[c - 1] == colour) unite(label - 1, label);
+        if (colour == 1 && block_2x2_ < 0 && rows_ > 0 && c > 0 &&
+            prev_colour_[c] == 1 && prev_colour_[c - 1] == 1 && cur_colour_[c - 1] == 1)
+            block_2x2_ = pos - cols_ - 1;
+    }
+
+    // Компоненти попереднього рядка, що не продовжились у поточний, завершені
+    std::fill(remap_.begin(), remap_.end(), -1);
+    for (int c = 0; c < cols_; ++c) remap_[find(cols_ + c)] = 0;
+    for (int i = 0; i < prev_count_; ++i) {
+        int root = find(i);
+        if (remap_[root] != -1) continue;
+        close(nodes_[root]);
+        remap_[root] = -2;
+    }
+
+    // Стискання: корені поточного рядка стають мітками 0..k-1 наступного кроку
+    std::fill(remap_.begin(), remap_.end(), -1);
+    int count = 0;
+    for (int c = 0; c < cols_; ++c) {
+        int root = find(cols_ + c);
+        if (remap_[root] < 0) {
+            remap_[root] = count;
+            compact_[count] = nodes_[root];
+            compact_[count].parent = count;
+            ++count;
+        }
+        prev_label_[c] = remap_[root];
+    }
+    nodes_.swap(compact_);
+    prev_colour_.swap(cur_colour_);
+    prev_count_ = count;
+    ++rows_;
+}
+
+// Метод для завершення перевірки
+solution_verdict streaming_solution_checker::finish() {
+    if (decided()) return value_error_;
+
+    // Компоненти останнього рядка завершуються разом із сіткою
+    for (int i = 0; i < prev_count_; ++i) close(nodes_[i]);
+    prev_count_ = 0;
+
+    // Пріоритет помилок той самий, що й у validate
+    solution_verdict verdict;
+    if (block_2x2_ >= 0) {
+        verdict.error = solution_verdict::kind::BLACK_2X2;
+        verdict.at = to_cell(block_2x2_);
+        return verdict;
+    }
+    if (black_second_ >= 0) {
+        verdict.error = solution_verdict::kind::BLACK_DISCONNECTED;
+        verdict.at = to_cell(black_second_);
+        return verdict;
+    }
+    return island_error_;
+}
+
+// Помилка формату з місцем у потоці
+[[noreturn]] static void stream_error(const char *source, const char *message, long long line, long long column) {
+    throw std::runtime_error(std::string(source) + ": " + message + " (рядок " + std::to_string(line) +
+                             ", стовпець " + std::to_string(column) + ")");
+}
+
+// Метод для потокової перевірки з текстових потоків
+solution_verdict streaming_solution_checker::validate_stream(std::istream &puzzle, std::istream &solution) {
+    number_reader puzzle_in(puzzle), solution_in(solution);
+    number_reader::token t;
+
+    // Розміри задачі
+    int rows = 0, cols = 0;
+    for (int *side : { &rows, &cols }) {
+        if (!puzzle_in.next(t))
+            stream_error("задача", "Невірний формат розмірів", puzzle_in.end_line(), puzzle_in.end_column());
+        if (!number_reader::parse(t, *side) || *side <= 0)
+            stream_error("задача", "Невірний формат розмірів", t.line, t.column);
+    }
+    long long max_value = static_cast<long long>(rows) * cols;
+
+    // У пам'яті лише поточні рядки задачі й рішення
+    std::vector<int> clues(cols), row(cols);
+    streaming_solution_checker checker(cols);
+    for (int r = 0; r < rows && !checker.decided(); ++r) {
+        for (int c = 0; c < cols; ++c) {
+            if (!puzzle_in.next(t))
+                stream_error("задача", "Недостатньо даних для сітки", puzzle_in.end_line(), puzzle_in.end_column());
+            if (!number_reader::parse(t, clues[c])) stream_error("задача", "Невірне число", t.line, t.column);
+            if (clues[c] < 0 || clues[c] > max_value)
+                stream_error("задача", "Недопустиме значення клітинки", t.line, t.column);
+
+            if (!solution_in.next(t))
+                stream_error("рішення", "Недостатньо даних для сітки", solution_in.end_line(), solution_in.end_column());
+            if (!number_reader::parse(t, row[c])) stream_error("рішення", "Невірне число", t.line, t.column);
+        }
+        checker.push_row(clues.data(), row.data());
+    }
+    return checker.finish();
 }
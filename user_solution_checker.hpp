@@ -5,11 +5,37 @@
 #include <iostream>
 #include <string>
 #include "cell.hpp"
+#include "flat_grid.hpp"
+
+// Результат перевірки рішення: вид помилки і клітинка, де її знайдено
+struct solution_verdict {
+    enum class kind {
+        OK,
+        SIZE_MISMATCH,        // розміри рішення не збігаються з розмірами задачі
+        BAD_VALUE,            // значення не є чорною, заповненою клітинкою чи підказкою
+        CLUE_MISMATCH,        // підказка рішення не збігається з підказкою задачі
+        BLACK_2X2,            // чорний блок 2x2 (клітинка — його верхній лівий кут)
+        BLACK_DISCONNECTED,   // чорна область незв'язна (клітинка — перша клітинка іншої частини)
+        ISLAND_MANY_CLUES,    // острів має більше однієї підказки (клітинка — друга підказка)
+        ISLAND_NO_CLUE,       // острів без підказки (клітинка — його перша клітинка)
+        ISLAND_SIZE           // площа острова не дорівнює підказці (клітинка — підказка)
+    };
+
+    kind error = kind::OK;
+    cell at = cell(-1, -1);
+    int expected = 0;   // CLUE_MISMATCH, ISLAND_SIZE: очікуване значення (підказка задачі)
+    int actual = 0;     // CLUE_MISMATCH, BAD_VALUE, ISLAND_SIZE: знайдене значення або площа
+
+    bool ok() const { return error == kind::OK; }
+
+    // Опис помилки українською, разом з рядком і стовпцем
+    std::string message() const;
+};
 
 class user_solution_checker {
 public:
     // Ініціалізація перевірки з початковою сіткою
-    user_solution_checker(const std::vector<std::vector<int>> &initial_grid);
+    user_solution_checker(const flat_grid &initial_grid);
 
     /*
         Інтерактивне зчитування рішення та його перевірка
@@ -18,31 +44,107 @@ public:
     */
     bool input_solution_interactive(std::istream &in, std::ostream &out);
 
+    /*
+        Перевірка готового рішення без зчитування і виводу.
+        Рішення — сітка тих самих розмірів: -1 — чорна клітинка, -2 — заповнена, n > 0 — підказка задачі.
+        Усі перевірки (чорні блоки 2x2, зв'язність чорної області, острови) виконуються одним проходом
+        розмітки компонент; для кількох помилок повертається та, яку знайшла б покрокова перевірка першою
+    */
+    static solution_verdict validate(const flat_grid &initial, const flat_grid &solution);
+
+    /*
+        Паралельна перевірка багатьох рішень: solutions[i] перевіряється щодо initials[i],
+        або щодо initials[0], якщо задача одна на всі рішення. threads = 0 — усі ядра.
+        Результати повертаються в порядку рішень
+    */
+    static std::vector<solution_verdict> validate_batch(const std::vector<flat_grid> &initials,
+                                                        const std::vector<flat_grid> &solutions,
+                                                        unsigned threads = 0);
+
 private:
-    const std::vector<std::vector<int>> &initial_;
+    // Мікробенчмарки (nurikabe_bench.cpp) вимірюють фазу перевірки окремо від зчитування
+    friend struct nurikabe_bench;
+
+    const flat_grid &initial_;
     int rows_, cols_;
-    std::vector<std::vector<int>> user_grid_;
+    flat_grid user_grid_;
 
     // Фаза зчитування даних від користувача
     bool input_phase(std::istream &in, std::ostream &out);
 
     // Фаза перевірки правильності введеного розв’язку
     bool validation_phase(std::ostream &out);
+};
+
+/*
+    Потокова перевірка рішення рядок за рядком для дуже великих сіток: пам'ять O(cols), а не O(rows × cols).
+    Компоненти (чорні й острови) розмічаються системою неперетинних множин лише над двома рядками — попереднім
+    і поточним; після кожного рядка мітки стискаються, а компонента, що не продовжилась у новий рядок, завершена
+    і перевіряється одразу (площа острова, кількість підказок, кількість чорних компонент).
+    Вердикт збігається з user_solution_checker::validate для тієї ж пари сіток.
+
+    Використання:
+        streaming_solution_checker checker(cols);
+        for (кожен рядок) checker.push_row(clues, row);
+        solution_verdict verdict = checker.finish();
+*/
+class streaming_solution_checker {
+public:
+    explicit streaming_solution_checker(int cols);
+
+    // Додає наступний рядок: clues — рядок задачі, row — рядок рішення, по cols значень кожен
+    void push_row(const int *clues, const int *row);
+
+    // Вердикт уже визначено помилкою значення чи підказки — решту рядків можна не подавати
+    bool decided() const { return !value_error_.ok(); }
+
+    // Завершує перевірку після останнього рядка і повертає вердикт
+    solution_verdict finish();
+
+    /*
+        Перевірка з текстових потоків, рядок за рядком: задача у форматі input.txt (одна сітка),
+        рішення — rows × cols значень (-1 — чорна, -2 — заповнена, n > 0 — підказка) без заголовка.
+        Помилки формату кидають std::runtime_error з рядком і стовпцем
+    */
+    static solution_verdict validate_stream(std::istream &puzzle, std::istream &solution);
+
+private:
+    // Компонента або її частина в межах двох рядків; позиції клітинок — r * cols + c
+    struct node {
+        int parent;
+        int colour;             // 1 — чорна, 2 — біла
+        long long size;         // площа (дійсна для кореня)
+        long long first;        // перша клітинка компоненти
+        long long clue;         // перша підказка або -1
+        long long extra_clue;   // друга підказка або -1
+        int clue_value;         // значення першої підказки
+    };
 
-    // Перевірка наявності чорного блока 2x2. Якщо знайдено — повертає координати верхнього лівого кута.
-    bool check_black_2x2_block(cell &lt) const;
+    int cols_;
+    long long rows_ = 0;                // кількість поданих рядків
+    std::vector<node> nodes_;           // мітки попереднього рядка [0, cols) і поточного [cols, 2 cols)
+    std::vector<node> compact_;         // буфер для стискання міток
+    std::vector<int> prev_label_;       // мітка кожної клітинки попереднього рядка
+    std::vector<int> prev_colour_;      // колір клітинок попереднього рядка
+    std::vector<int> cur_colour_;
+    std::vector<int> remap_;            // нова мітка кореня або -1; для попередніх міток — ознака продовження
+    int prev_count_ = 0;                // кількість міток попереднього рядка
 
-    // Перевірка зв’язності чорної області
-    bool check_black_connectivity() const;
+    solution_verdict value_error_;      // перша помилка значення чи підказки
+    long long block_2x2_ = -1;          // верхній лівий кут першого чорного блока 2x2
+    long long black_first_ = -1;        // перші клітинки двох найраніших чорних компонент
+    long long black_second_ = -1;
+    solution_verdict island_error_;     // помилка найранішого хибного острова
+    long long island_first_ = -1;       // перша клітинка цього острова
 
-    // Перевірка коректності островів. У разі помилки повертає причину та місце.
-    bool check_islands(std::string &reason, cell &loc) const;
+    int find(int id);
+    void unite(int a, int b);
 
-    static constexpr int DR_[4] = {-1, 1, 0, 0};
-    static constexpr int DC_[4] = {0, 0, -1, 1};
+    // Перевіряє завершену компоненту
+    void close(const node &n);
 
-    // Перевірка виходу за межі сітки
-    bool out_of_bounds(int r, int c) const {
-        return r < 0 || c < 0 || r >= rows_ || c >= cols_;
+    // Координати клітинки за позицією
+    cell to_cell(long long pos) const {
+        return cell(static_cast<int>(pos / cols_), static_cast<int>(pos % cols_));
     }
 };